@@ -0,0 +1,349 @@
+/**
+ * @file bench.cc
+ *
+ * Benchmark suite of the CSV parsers and the composer.
+ *
+ * Measures a matrix of parser engines and CSV data shapes
+ * (narrow, quote-heavy, wide rows, long fields, CRLF, padded
+ * fields with trimming, comment headers), and the composer
+ * throughput. The test data are generated once per shape
+ * (reproducible, fixed seed) before the measurements. Each
+ * measurement is repeated, the median time is reported as
+ * machine-readable JSON or CSV on stdout (progress on stderr):
+ *
+ *  - bytes, rows, seconds (median, steady clock),
+ *  - mb_per_s, rows_per_s,
+ *  - allocs_per_row (heap allocations / rows, all threads).
+ *
+ * Usage (`make bench`, see `bench/bench.mk`):
+ *
+ *   bench.elf [--size-mb=16] [--repeat=5] [--format=json|csv] [--filter=text]
+ *
+ * `--filter` selects the measurements with the text in the
+ * "suite/engine/shape" name, e.g. `--filter=view` or `--filter=/wide`.
+ */
+#include <include/csv.hh>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef SCM_COMMIT
+  #define SCM_COMMIT "0000000"
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Allocation counting (all threads).
+
+namespace { std::atomic<size_t> num_allocations(0); }
+
+void* operator new(std::size_t size)
+{
+  ++num_allocations;
+  if(void* p = std::malloc(size ? size : 1)) return p; // NOLINT(cppcoreguidelines-no-malloc)
+  throw std::bad_alloc();
+}
+
+// Not inlined, so that the compiler does not pair `free()` with the builtin `operator new`.
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); } // NOLINT(cppcoreguidelines-no-malloc)
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); } // NOLINT(cppcoreguidelines-no-malloc)
+
+//--------------------------------------------------------------------------------------------------
+
+namespace {
+
+  /**
+   * CSV data shape of a benchmark data set.
+   */
+  struct shape_type
+  {
+    std::string name;           // Shape name in the results.
+    size_t num_cols;            // Number of columns.
+    size_t max_field_length;    // Maximum number of characters of a field (random length).
+    std::string pool;           // Characters of the fields.
+    std::string newline;        // Line separator.
+    bool trim;                  // Padded fields, parsed with trimming enabled.
+    size_t num_comment_lines;   // Number of header comment lines.
+  };
+
+  /**
+   * Result of one benchmark measurement.
+   */
+  struct result_type
+  {
+    std::string suite, engine, shape;
+    size_t bytes, rows;
+    double seconds;
+    size_t allocations;
+  };
+
+  using dialect_type = csv::csv_dialect<',', true, csv::csv_chars<'#'>>;
+  using trim_dialect_type = csv::csv_dialect<',', true, csv::csv_chars<'#'>, csv::csv_chars<' ', '\t'>>;
+
+  const auto ascii_pool = std::string("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-+*/.:!?=()[]{}<>");
+
+  std::vector<shape_type> shapes()
+  {
+    return std::vector<shape_type>{
+      {"narrow",      8,   16,   ascii_pool,                "\n",   false, 0},
+      {"quoted",      8,   24,   ascii_pool + "\"\",,\n ",  "\n",   false, 0},
+      {"wide",        128, 8,    ascii_pool,                "\n",   false, 0},
+      {"long_fields", 4,   1024, ascii_pool + " ",          "\n",   false, 0},
+      {"crlf",        8,   16,   ascii_pool,                "\r\n", false, 0},
+      {"trim",        8,   16,   ascii_pool + " ",          "\n",   true,  0},
+      {"comments",    8,   16,   ascii_pool,                "\n",   false, 10000},
+    };
+  }
+
+  /**
+   * Generates the CSV text of a shape with approximately `size` bytes.
+   */
+  std::string make_csv_text(const shape_type& shape, const size_t size, std::mt19937& rng)
+  {
+    const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',', shape.newline);
+    auto text = std::string();
+    text.reserve(size + 64 * 1024);
+    for(size_t i = 0; i < shape.num_comment_lines; ++i) text += "# header comment line " + std::to_string(i) + shape.newline;
+    auto field = std::string();
+    while(text.size() < size) {
+      for(size_t col = 0; col < shape.num_cols; ++col) {
+        // Non-empty first field, so that no row is an empty line.
+        field.resize(std::uniform_int_distribution<size_t>((col == 0) ? 1 : 0, shape.max_field_length)(rng));
+        for(auto& c: field) c = shape.pool[std::uniform_int_distribution<size_t>(0, shape.pool.size() - 1)(rng)];
+        if(col > 0) text += ',';
+        if(shape.trim) text.append(std::uniform_int_distribution<size_t>(0, 6)(rng), ' ');
+        if((col == 0) && (field.front() == '#')) field.front() = '_';
+        text += composer.escape(field);
+        if(shape.trim) text.append(std::uniform_int_distribution<size_t>(0, 6)(rng), ' ');
+      }
+      text += shape.newline;
+    }
+    return text;
+  }
+
+  /**
+   * Runs `fn()` (returning the number of rows) `repeat` times,
+   * returns the result with the median time.
+   */
+  template<typename Function>
+  result_type measure(const Function& fn, const size_t repeat)
+  {
+    using namespace std::chrono;
+    auto runs = std::vector<result_type>();
+    for(size_t i = 0; i < repeat; ++i) {
+      const auto allocations = num_allocations.load();
+      const auto start = steady_clock::now();
+      const auto rows = fn();
+      const auto seconds = duration<double>(steady_clock::now() - start).count();
+      runs.push_back(result_type{"", "", "", 0, rows, seconds, num_allocations.load() - allocations});
+    }
+    std::sort(runs.begin(), runs.end(), [](const auto& a, const auto& b){ return a.seconds < b.seconds; });
+    return runs[runs.size() / 2];
+  }
+
+  /**
+   * Parser engines: Parse the file of a shape, return the number of rows.
+   */
+  std::vector<std::pair<std::string, std::function<size_t(const std::filesystem::path&, const shape_type&)>>> parser_engines()
+  {
+    using namespace std;
+    using path_type = filesystem::path;
+    const auto trim_chars = [](const shape_type& shape){ return shape.trim ? string_view(" \t") : string_view(""); };
+    return {
+      {"csv_parser", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        csv::csv_parser([&](const vector<string>&, size_t){ ++rows; }, ',', "#", trim_chars(shape)).parse_file(path);
+        return rows;
+      }},
+      {"csv_instrumented_parser", [=](const path_type& path, const shape_type& shape){
+        auto parser = csv::csv_instrumented_parser([](const vector<string>&, size_t){}, ',', "#", trim_chars(shape));
+        parser.parse_file(path);
+        return parser.stats().num_rows;
+      }},
+      {"csv_parser_scan", [=](const path_type& path, const shape_type& shape){
+        return csv::csv_parser([](const vector<string>&, size_t){}, ',', "#", trim_chars(shape)).scan_file(path).num_rows;
+      }},
+      {"csv_inline_parser", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        const auto on_row = [&](const vector<string>&, size_t){ ++rows; };
+        csv::csv_inline_parser<decltype(on_row)>(on_row, ',', "#", trim_chars(shape)).parse_file(path);
+        return rows;
+      }},
+      {"csv_pooled_parser", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        csv::csv_pooled_parser([&](const csv::csv_field_pool&, size_t){ ++rows; }, ',', "#", trim_chars(shape)).parse_file(path);
+        return rows;
+      }},
+      {"csv_dialect_parser", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        const auto on_row = [&](const vector<string>&, size_t){ ++rows; };
+        if(shape.trim) {
+          csv::csv_dialect_parser<trim_dialect_type, decltype(on_row)>(on_row).parse_file(path);
+        } else {
+          csv::csv_dialect_parser<dialect_type, decltype(on_row)>(on_row).parse_file(path);
+        }
+        return rows;
+      }},
+      {"csv_parser_pipelined", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        csv::csv_parser([&](const vector<string>&, size_t){ ++rows; }, ',', "#", trim_chars(shape)).parse_file_pipelined(path);
+        return rows;
+      }},
+      {"csv_view_parser", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        const auto on_row = [&](const vector<string_view>&, size_t){ ++rows; };
+        csv::csv_inline_view_parser<decltype(on_row)>(on_row, ',', "#", trim_chars(shape)).parse_file(path);
+        return rows;
+      }},
+      {"csv_view_parser_parallel", [=](const path_type& path, const shape_type& shape){
+        auto rows = atomic<size_t>(0);
+        csv::csv_view_parser([&](const vector<string_view>&, size_t){ ++rows; }, ',', "#", trim_chars(shape)).parse_file_parallel(path);
+        return rows.load();
+      }},
+      {"csv_column_batcher", [=](const path_type& path, const shape_type& shape){
+        auto rows = size_t(0);
+        auto batcher = csv::csv_column_batcher([&](const csv::csv_column_batch& batch){ rows += batch.size(); });
+        csv::csv_inline_view_parser<decltype(std::ref(batcher))>(std::ref(batcher), ',', "#", trim_chars(shape)).parse_file(path);
+        batcher.flush();
+        return rows;
+      }},
+    };
+  }
+
+  /**
+   * Composer engines: Compose the rows, return the number of output bytes.
+   */
+  std::vector<std::pair<std::string, std::function<size_t(const std::vector<std::vector<std::string>>&)>>> composer_engines()
+  {
+    using namespace std;
+    using rows_type = vector<vector<string>>;
+    return {
+      {"csv_composer", [](const rows_type& rows){
+        auto bytes = size_t(0);
+        auto composer = csv::csv_composer([&](const string& block){ bytes += block.size(); }, ',', "\n", 1024 * 1024);
+        composer.define_columns(rows.front().size());
+        for(const auto& row: rows) composer.feed(row);
+        composer.flush();
+        return bytes;
+      }},
+      {"csv_composer_parallel", [](const rows_type& rows){
+        auto bytes = size_t(0);
+        auto composer = csv::csv_composer([&](const string& block){ bytes += block.size(); }, ',', "\n");
+        composer.define_columns(rows.front().size());
+        composer.feed_parallel(rows);
+        return bytes;
+      }},
+    };
+  }
+
+  void print_results(const std::vector<result_type>& results, const std::string& format)
+  {
+    using namespace std;
+    const auto mb_per_s = [](const result_type& r){ return double(r.bytes) / (1024.0 * 1024.0) / std::max(r.seconds, 1e-9); };
+    const auto rows_per_s = [](const result_type& r){ return double(r.rows) / std::max(r.seconds, 1e-9); };
+    const auto allocs_per_row = [](const result_type& r){ return double(r.allocations) / double(std::max(r.rows, size_t(1))); };
+    if(format == "csv") {
+      auto composer = csv::csv_composer([](const string& line){ cout << line; }, ',', "\n");
+      composer.define_columns(10);
+      composer.feed(array<string, 10>{"commit", "suite", "engine", "shape", "bytes", "rows", "seconds", "mb_per_s", "rows_per_s", "allocs_per_row"});
+      for(const auto& r: results) {
+        composer.feed(array<string, 10>{SCM_COMMIT, r.suite, r.engine, r.shape, to_string(r.bytes), to_string(r.rows),
+          to_string(r.seconds), to_string(mb_per_s(r)), to_string(rows_per_s(r)), to_string(allocs_per_row(r))});
+      }
+      return;
+    }
+    cout << "[\n";
+    for(size_t i = 0; i < results.size(); ++i) {
+      const auto& r = results[i];
+      cout << "  {\"commit\": \"" << SCM_COMMIT << "\", \"suite\": \"" << r.suite << "\", \"engine\": \"" << r.engine
+           << "\", \"shape\": \"" << r.shape << "\", \"bytes\": " << r.bytes << ", \"rows\": " << r.rows
+           << ", \"seconds\": " << r.seconds << ", \"mb_per_s\": " << mb_per_s(r) << ", \"rows_per_s\": " << rows_per_s(r)
+           << ", \"allocs_per_row\": " << allocs_per_row(r) << "}" << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    cout << "]\n";
+  }
+
+}
+
+int main(int argc, char* argv[])
+{
+  using namespace std;
+  auto size_mb = size_t(16);
+  auto repeat = size_t(5);
+  auto format = string("json");
+  auto filter = string();
+  for(int i = 1; i < argc; ++i) {
+    const auto arg = string_view(argv[i]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const auto value = [&](const string_view key){ return (arg.substr(0, key.size()) == key) ? string(arg.substr(key.size())) : string(); };
+    if(!value("--size-mb=").empty()) {
+      size_mb = size_t(std::max(1, atoi(value("--size-mb=").c_str())));
+    } else if(!value("--repeat=").empty()) {
+      repeat = size_t(std::max(1, atoi(value("--repeat=").c_str())));
+    } else if(!value("--format=").empty()) {
+      format = value("--format=");
+    } else if(!value("--filter=").empty()) {
+      filter = value("--filter=");
+    } else {
+      cerr << "Usage: " << argv[0] << " [--size-mb=16] [--repeat=5] [--format=json|csv] [--filter=text]\n";
+      return 1;
+    }
+  }
+
+  auto rng = std::mt19937(42);
+  auto results = vector<result_type>();
+  const auto selected = [&](const string& name){ return filter.empty() || (name.find(filter) != name.npos); };
+  try {
+    for(const auto& shape: shapes()) {
+      const auto text = make_csv_text(shape, size_mb * 1024 * 1024, rng);
+      const auto path = filesystem::path("bench-" + shape.name + ".csv");
+      {
+        auto fos = ofstream(path, ios::binary);
+        fos.write(text.data(), streamsize(text.size()));
+        if(!fos) throw runtime_error("Failed to write benchmark file.");
+      }
+      for(const auto& [engine, parse]: parser_engines()) {
+        const auto name = "parse/" + engine + "/" + shape.name;
+        if(!selected(name)) continue;
+        cerr << "[bench] " << name << " ..." << endl;
+        auto result = measure([&](){ return parse(path, shape); }, repeat);
+        result.suite = "parse";
+        result.engine = engine;
+        result.shape = shape.name;
+        result.bytes = text.size();
+        results.push_back(result);
+      }
+      filesystem::remove(path);
+
+      // Composer input: The parsed rows of (up to 4MB of) the shape data.
+      auto rows = vector<vector<string>>();
+      const auto compose_text = string_view(text).substr(0, std::min(text.size(), size_t(4 * 1024 * 1024)));
+      csv::csv_parser([&](const vector<string>& fields, size_t){ if(fields.size() == shape.num_cols) rows.push_back(fields); }, ',', "#").parse(compose_text);
+      for(const auto& [engine, compose]: composer_engines()) {
+        const auto name = "compose/" + engine + "/" + shape.name;
+        if((!selected(name)) || rows.empty()) continue;
+        cerr << "[bench] " << name << " ..." << endl;
+        auto bytes = size_t(0);
+        auto result = measure([&](){ bytes = compose(rows); return rows.size(); }, repeat);
+        result.suite = "compose";
+        result.engine = engine;
+        result.shape = shape.name;
+        result.bytes = bytes;
+        results.push_back(result);
+      }
+    }
+  } catch(const exception& e) {
+    cerr << "[error] " << e.what() << endl;
+    return 1;
+  }
+  print_results(results, format);
+  return 0;
+}
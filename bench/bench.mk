@@ -0,0 +1,25 @@
+#---------------------------------------------------------------------------------------------------
+# Benchmark suite (`bench/bench.cc`), not part of the tests:
+#
+#   make bench [BENCH_FORMAT=json|csv] [BENCH_ARGS="--size-mb=64 --repeat=7 --filter=view"]
+#
+# The results are printed and saved as `$(BUILDDIR)/bench/results.<format>`.
+#---------------------------------------------------------------------------------------------------
+.PHONY: bench bench-clean
+
+BENCH_FORMAT=json
+BENCH_ARGS=
+BENCH_BINARY:=$(BUILDDIR)/bench/bench$(BINARY_EXTENSION)
+
+bench: $(BENCH_BINARY)
+	@echo "[bench] $(BUILDDIR)/bench/results.$(BENCH_FORMAT)"
+	@cd $(BUILDDIR)/bench && ./$(notdir $(BENCH_BINARY)) --format=$(BENCH_FORMAT) $(BENCH_ARGS) > results.$(BENCH_FORMAT)
+	@cat $(BUILDDIR)/bench/results.$(BENCH_FORMAT)
+
+bench-clean:
+	@rm -rf $(BUILDDIR)/bench
+
+$(BENCH_BINARY): bench/bench.cc include/csv.hh
+	@echo "[c++ ] $@"
+	@mkdir -p $(dir $@)
+	@$(CXX) -o $@ $< $(FLAGSCXX) -I. $(FLAGSLD) $(LDSTATIC) $(LIBS) $(OPTS) -DSCM_COMMIT='"""$(SCM_COMMIT)"""'
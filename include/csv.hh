@@ -32,304 +32,3790 @@
 #ifndef SW_CSV_PARSER_HH
 #define	SW_CSV_PARSER_HH
 #include <functional>
+#include <array>
+#include <atomic>
 #include <filesystem>
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iterator>
+#include <limits>
 #include <numeric>
 #include <fstream>
+#include <exception>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(WITH_CSV_ZLIB)
+  #include <zlib.h>
+#endif
+#if defined(WITH_CSV_ZSTD)
+  #include <zstd.h>
+#endif
+#if !defined(WITHOUT_CSV_MMAP)
+  #if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+      #define NOMINMAX
+    #endif
+    #include <windows.h>
+  #elif defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+  #else
+    #define WITHOUT_CSV_MMAP
+  #endif
+#endif
+#if !defined(WITHOUT_CSV_SIMD)
+  #if defined(__AVX2__)
+    #define SW_CSV_SIMD_AVX2
+  #endif
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define SW_CSV_SIMD_SSE2
+    #include <immintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define SW_CSV_SIMD_NEON
+    #include <arm_neon.h>
+  #endif
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+
+/**
+ * CSV parsing.
+ */
+namespace csv { namespace {
+
+  namespace detail {
+
+    /**
+     * Read-only memory mapped file (POSIX `mmap()`, Windows
+     * `MapViewOfFile()`), used to parse files in place. The
+     * mapping is not available for empty or non-regular files,
+     * or if `WITHOUT_CSV_MMAP` is defined. `data()` is `nullptr`
+     * in this case, and the caller falls back to stream reading.
+     */
+    class mapped_file
+    {
+    public:
+
+      mapped_file() noexcept = default;
+      mapped_file(const mapped_file&) = delete;
+      mapped_file& operator=(const mapped_file&) = delete;
+      ~mapped_file() noexcept { close(); }
+
+      mapped_file(mapped_file&& o) noexcept : data_(o.data_), size_(o.size_)
+      { o.data_ = nullptr; o.size_ = 0; }
+
+      mapped_file& operator=(mapped_file&& o) noexcept
+      {
+        if(this == &o) return *this;
+        close();
+        std::swap(data_, o.data_);
+        std::swap(size_, o.size_);
+        return *this;
+      }
+
+      /**
+       * Maps the file given by its filesystem path, does
+       * not throw if the file cannot be mapped.
+       * @param const std::filesystem::path& path
+       */
+      explicit mapped_file(const std::filesystem::path& path) noexcept
+      { open(path); }
+
+    public:
+
+      /**
+       * Returns the start of the mapped file data,
+       * or `nullptr` if not mapped.
+       * @return const char*
+       */
+      const char* data() const noexcept
+      { return data_; }
+
+      /**
+       * Returns the size of the mapped region (the
+       * file size).
+       * @return size_t
+       */
+      size_t size() const noexcept
+      { return size_; }
+
+      /**
+       * Returns true if the file is mapped.
+       * @return bool
+       */
+      bool is_open() const noexcept
+      { return data_ != nullptr; }
+
+      /**
+       * Returns the mapped file data as string view.
+       * @return std::string_view
+       */
+      std::string_view view() const noexcept
+      { return is_open() ? std::string_view(data_, size_) : std::string_view(); }
+
+    public:
+
+      /**
+       * Maps the file given by its filesystem path (read-only,
+       * sequential access hint). Returns false if the file could
+       * not be mapped.
+       * @param const std::filesystem::path& path
+       * @return bool
+       */
+      bool open(const std::filesystem::path& path) noexcept
+      {
+        close();
+        #if defined(WITHOUT_CSV_MMAP)
+        (void)path;
+        return false;
+        #elif defined(_WIN32)
+        const auto fh = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(fh == INVALID_HANDLE_VALUE) return false;
+        auto file_size = LARGE_INTEGER();
+        if((!::GetFileSizeEx(fh, &file_size)) || (file_size.QuadPart <= 0) || (uint64_t(file_size.QuadPart) > uint64_t(SIZE_MAX))) {
+          ::CloseHandle(fh);
+          return false;
+        }
+        const auto mh = ::CreateFileMappingW(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(fh);
+        if(mh == nullptr) return false;
+        const auto p = ::MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mh);
+        if(p == nullptr) return false;
+        data_ = static_cast<const char*>(p);
+        size_ = size_t(file_size.QuadPart);
+        return true;
+        #else
+        const auto fd = ::open(path.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        if(fd < 0) return false;
+        struct ::stat st = {};
+        if((::fstat(fd, &st) != 0) || (!S_ISREG(st.st_mode)) || (st.st_size <= 0) || (uint64_t(st.st_size) > uint64_t(SIZE_MAX))) {
+          ::close(fd);
+          return false;
+        }
+        const auto p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED) return false; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        ::madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+        size_ = size_t(st.st_size);
+        return true;
+        #endif
+      }
+
+      /**
+       * Unmaps the file, if mapped.
+       */
+      void close() noexcept
+      {
+        if(data_ == nullptr) return;
+        #if defined(_WIN32) && !defined(WITHOUT_CSV_MMAP)
+        ::UnmapViewOfFile(data_);
+        #elif !defined(WITHOUT_CSV_MMAP)
+        ::munmap(const_cast<char*>(data_), size_); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+        #endif
+        data_ = nullptr;
+        size_ = 0;
+      }
+
+    private:
+
+      const char* data_ = nullptr;  // Start of the mapped file data.
+      size_t size_ = 0;             // Size of the mapped region.
+    };
+
+    /**
+     * Returns the number of trailing zero bits of a
+     * non-zero 32 bit value.
+     * @param const uint32_t bits
+     * @return unsigned
+     */
+    inline unsigned count_trailing_zeros(const uint32_t bits) noexcept
+    {
+      #if defined(_MSC_VER)
+      auto index = 0ul;
+      _BitScanForward(&index, bits);
+      return unsigned(index);
+      #else
+      return unsigned(__builtin_ctz(bits));
+      #endif
+    }
+
+    /**
+     * Returns the position of the first character in `[p, end)`,
+     * which is one of the `needles`, or `end` if there is none.
+     * The range is checked 32 (AVX2) or 16 (SSE2, NEON) bytes
+     * at a time, depending on the compiler target settings, and
+     * byte-wise for the remaining characters. `WITHOUT_CSV_SIMD`
+     * selects the scalar implementation.
+     * @tparam size_t N
+     * @param const char* p
+     * @param const char* const end
+     * @param const std::array<char, N>& needles
+     * @return const char*
+     */
+    template<size_t N>
+    inline const char* find_first_of(const char* p, const char* const end, const std::array<char, N>& needles) noexcept
+    {
+      static_assert((N > 0) && (N <= 4), "Only 1 to 4 characters can be searched at once.");
+      if constexpr(N == 1) {
+        const auto pos = static_cast<const char*>(std::memchr(p, needles[0], size_t(end - p)));
+        return (pos != nullptr) ? (pos) : (end);
+      } else {
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        #if defined(SW_CSV_SIMD_AVX2)
+        {
+          __m256i vn[N]; // NOLINT(cppcoreguidelines-avoid-c-arrays): std::array drops the vector type attributes.
+          for(size_t i = 0; i < N; ++i) vn[i] = _mm256_set1_epi8(needles[i]);
+          for(; (end - p) >= 32; p += 32) {
+            const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            auto m = _mm256_cmpeq_epi8(v, vn[0]);
+            for(size_t i = 1; i < N; ++i) m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, vn[i]));
+            const auto bits = uint32_t(_mm256_movemask_epi8(m));
+            if(bits != 0) return p + count_trailing_zeros(bits);
+          }
+        }
+        #endif
+        #if defined(SW_CSV_SIMD_SSE2)
+        {
+          __m128i vn[N]; // NOLINT(cppcoreguidelines-avoid-c-arrays): std::array drops the vector type attributes.
+          for(size_t i = 0; i < N; ++i) vn[i] = _mm_set1_epi8(needles[i]);
+          for(; (end - p) >= 16; p += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            auto m = _mm_cmpeq_epi8(v, vn[0]);
+            for(size_t i = 1; i < N; ++i) m = _mm_or_si128(m, _mm_cmpeq_epi8(v, vn[i]));
+            const auto bits = uint32_t(_mm_movemask_epi8(m));
+            if(bits != 0) return p + count_trailing_zeros(bits);
+          }
+        }
+        #elif defined(SW_CSV_SIMD_NEON)
+        {
+          uint8x16_t vn[N]; // NOLINT(cppcoreguidelines-avoid-c-arrays): std::array drops the vector type attributes.
+          for(size_t i = 0; i < N; ++i) vn[i] = vdupq_n_u8(uint8_t(needles[i]));
+          for(; (end - p) >= 16; p += 16) {
+            const auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+            auto m = vceqq_u8(v, vn[0]);
+            for(size_t i = 1; i < N; ++i) m = vorrq_u8(m, vceqq_u8(v, vn[i]));
+            // Narrowing shift: 4 mask bits per byte in a 64 bit value.
+            const auto bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+            if(bits == 0) continue;
+            const auto lo = uint32_t(bits);
+            return p + ((lo != 0) ? (count_trailing_zeros(lo) / 4) : (8 + count_trailing_zeros(uint32_t(bits >> 32)) / 4));
+          }
+        }
+        #endif
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        for(; p != end; ++p) {
+          for(const auto c: needles) {
+            if(*p == c) return p;
+          }
+        }
+        return end;
+      }
+    }
+
+    /**
+     * Returns true if the text in `[p, end)` contains a character,
+     * which requires quoting when composing CSV: control characters
+     * (`< ' '`, also newlines), characters beyond `'~'` (non-ASCII),
+     * quotes (`"`), or the `delimiter`. Checked 32 (AVX2) or 16 (SSE2,
+     * NEON) bytes at a time, as `find_first_of()`.
+     * @param const char* p
+     * @param const char* const end
+     * @param const char delimiter
+     * @return bool
+     */
+    inline bool contains_quote_chars(const char* p, const char* const end, const char delimiter) noexcept
+    {
+      // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      #if defined(SW_CSV_SIMD_AVX2)
+      {
+        // Signed compare: Non-ASCII bytes are negative, hence also `< ' '`.
+        const auto vlo = _mm256_set1_epi8(' ');
+        const auto vhi = _mm256_set1_epi8('~');
+        const auto vquote = _mm256_set1_epi8('"');
+        const auto vdelim = _mm256_set1_epi8(delimiter);
+        for(; (end - p) >= 32; p += 32) {
+          const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+          const auto m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi8(vlo, v), _mm256_cmpgt_epi8(v, vhi)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, vquote), _mm256_cmpeq_epi8(v, vdelim))
+          );
+          if(_mm256_movemask_epi8(m) != 0) return true;
+        }
+      }
+      #endif
+      #if defined(SW_CSV_SIMD_SSE2)
+      {
+        const auto vlo = _mm_set1_epi8(' ');
+        const auto vhi = _mm_set1_epi8('~');
+        const auto vquote = _mm_set1_epi8('"');
+        const auto vdelim = _mm_set1_epi8(delimiter);
+        for(; (end - p) >= 16; p += 16) {
+          const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+          const auto m = _mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi8(v, vlo), _mm_cmpgt_epi8(v, vhi)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, vquote), _mm_cmpeq_epi8(v, vdelim))
+          );
+          if(_mm_movemask_epi8(m) != 0) return true;
+        }
+      }
+      #elif defined(SW_CSV_SIMD_NEON)
+      {
+        const auto vlo = vdupq_n_u8(uint8_t(' '));
+        const auto vhi = vdupq_n_u8(uint8_t('~'));
+        const auto vquote = vdupq_n_u8(uint8_t('"'));
+        const auto vdelim = vdupq_n_u8(uint8_t(delimiter));
+        for(; (end - p) >= 16; p += 16) {
+          const auto v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+          const auto m = vorrq_u8(
+            vorrq_u8(vcltq_u8(v, vlo), vcgtq_u8(v, vhi)),
+            vorrq_u8(vceqq_u8(v, vquote), vceqq_u8(v, vdelim))
+          );
+          if(vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0) != 0) return true;
+        }
+      }
+      #endif
+      // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      for(; p != end; ++p) {
+        const auto c = *p;
+        if((c < ' ') || (c == '"') || (c > '~') || (c == delimiter)) return true;
+      }
+      return false;
+    }
+
+    /**
+     * Field container, which recycles its strings: `clear()`
+     * only resets the logical size, the strings (and their
+     * allocated capacity) are kept and reused by subsequent
+     * `emplace_back()`/`push_back()` calls. Used as parser
+     * `StringContainerType`, the field storage is allocation
+     * free once the field buffers have grown to the row sizes.
+     */
+    template<
+      typename StringType           // String type used, @concept: must be std::string like.
+    >
+    class basic_field_pool
+    {
+    public:
+
+      using value_type = StringType;
+      using size_type = size_t;
+      using reference = value_type&;
+      using const_reference = const value_type&;
+      using iterator = typename std::vector<value_type>::iterator;
+      using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    public:
+
+      basic_field_pool() = default;
+      basic_field_pool(const basic_field_pool&) = default;
+      basic_field_pool(basic_field_pool&&) noexcept = default;
+      basic_field_pool& operator=(const basic_field_pool&) = default;
+      basic_field_pool& operator=(basic_field_pool&&) noexcept = default;
+      ~basic_field_pool() noexcept = default;
+
+    public:
+
+      size_type size() const noexcept { return size_; }
+      bool empty() const noexcept { return size_ == 0; }
+      size_type capacity() const noexcept { return slots_.size(); }
+
+      reference operator[](const size_type i) noexcept { return slots_[i]; }
+      const_reference operator[](const size_type i) const noexcept { return slots_[i]; }
+      reference front() noexcept { return slots_.front(); }
+      const_reference front() const noexcept { return slots_.front(); }
+      reference back() noexcept { return slots_[size_-1]; }
+      const_reference back() const noexcept { return slots_[size_-1]; }
+
+      iterator begin() noexcept { return slots_.begin(); }
+      iterator end() noexcept { return slots_.begin() + std::ptrdiff_t(size_); }
+      const_iterator begin() const noexcept { return slots_.begin(); }
+      const_iterator end() const noexcept { return slots_.begin() + std::ptrdiff_t(size_); }
+      const_iterator cbegin() const noexcept { return begin(); }
+      const_iterator cend() const noexcept { return end(); }
+
+      /**
+       * Resets the size, the strings are kept for reuse.
+       */
+      void clear() noexcept
+      { size_ = 0; }
+
+      /**
+       * Appends an empty string, reusing a kept one
+       * if available.
+       * @return reference
+       */
+      reference emplace_back()
+      {
+        if(size_ < slots_.size()) {
+          slots_[size_].clear();
+        } else {
+          slots_.emplace_back();
+        }
+        return slots_[size_++];
+      }
+
+      /**
+       * Appends a copy of a string, reusing a kept one
+       * if available.
+       * @param const value_type& s
+       */
+      void push_back(const value_type& s)
+      { emplace_back().assign(s); }
+
+    private:
+
+      std::vector<value_type> slots_; // Strings, including the kept ones beyond `size_`.
+      size_type size_ = 0;            // Number of used strings.
+    };
+
+    /**
+     * Compression formats of CSV input files.
+     */
+    enum class file_compression { none, gzip, zstd };
+
+    /**
+     * Returns the compression format of a file, determined by the
+     * magic bytes at the start of the file (independent of the file
+     * name extension). Files that cannot be read are `none`.
+     * @param const std::filesystem::path& path
+     * @return file_compression
+     */
+    inline file_compression compression_of(const std::filesystem::path& path)
+    {
+      auto fis = std::ifstream(path, std::ifstream::binary);
+      auto magic = std::array<char, 4>();
+      fis.read(magic.data(), std::streamsize(magic.size()));
+      const auto n = size_t(fis.gcount());
+      const auto is = [&](const std::string_view bytes){ return (n >= bytes.size()) && (std::string_view(magic.data(), bytes.size()) == bytes); };
+      if(is("\x1f\x8b")) return file_compression::gzip;
+      if(is("\x28\xb5\x2f\xfd")) return file_compression::zstd;
+      return file_compression::none;
+    }
+
+    /**
+     * Plain file input source of the `basic_pipelined_file_reader`.
+     * Sources are constructed with the file path (throwing if the
+     * file cannot be opened), and `read()` returns the number of
+     * characters read into the buffer, 0 at the end of the input,
+     * or throws on error.
+     */
+    class file_source
+    {
+    public:
+
+      file_source() = delete;
+      file_source(const file_source&) = delete;
+      file_source(file_source&&) = delete;
+      file_source& operator=(const file_source&) = delete;
+      file_source& operator=(file_source&&) = delete;
+      ~file_source() noexcept = default;
+
+      explicit file_source(const std::filesystem::path& path) : fis_(path, std::ifstream::binary)
+      { if(!fis_) throw std::runtime_error("Failed to open CSV file."); }
+
+      size_t read(char* const buffer, const size_t size)
+      {
+        if(fis_.eof()) return 0;
+        fis_.read(buffer, std::streamsize(size));
+        const auto n_read = size_t(fis_.gcount());
+        if((!fis_.good()) && (!fis_.eof())) throw std::runtime_error("Not all CSV file data could be read.");
+        return n_read;
+      }
+
+    private:
+
+      std::ifstream fis_; // Input file stream.
+    };
+
+    #if defined(WITH_CSV_ZLIB)
+    /**
+     * Gzip file input source (zlib), @see `file_source`.
+     */
+    class gzip_file_source
+    {
+    public:
+
+      gzip_file_source() = delete;
+      gzip_file_source(const gzip_file_source&) = delete;
+      gzip_file_source(gzip_file_source&&) = delete;
+      gzip_file_source& operator=(const gzip_file_source&) = delete;
+      gzip_file_source& operator=(gzip_file_source&&) = delete;
+
+      explicit gzip_file_source(const std::filesystem::path& path)
+      #if defined(_WIN32)
+      : file_(gzopen_w(path.c_str(), "rb"))
+      #else
+      : file_(gzopen(path.c_str(), "rb"))
+      #endif
+      {
+        if(file_ == nullptr) throw std::runtime_error("Failed to open CSV file.");
+        gzbuffer(file_, 128u * 1024u);
+      }
+
+      ~gzip_file_source() noexcept
+      { gzclose(file_); }
+
+      size_t read(char* const buffer, const size_t size)
+      {
+        const auto n_read = gzread(file_, buffer, unsigned(std::min(size, size_t(std::numeric_limits<int>::max()))));
+        if(n_read < 0) throw std::runtime_error("Failed to decompress CSV file (zlib).");
+        if(n_read == 0) {
+          // gzread() does not fail for truncated data (Z_BUF_ERROR), to allow reading files being written.
+          auto error = Z_OK;
+          gzerror(file_, &error);
+          if(error != Z_OK) throw std::runtime_error("Failed to decompress CSV file (zlib): truncated data.");
+        }
+        return size_t(n_read);
+      }
+
+    private:
+
+      gzFile file_; // zlib file handle.
+    };
+    #endif
+
+    #if defined(WITH_CSV_ZSTD)
+    /**
+     * Zstandard file input source (libzstd streaming
+     * decompression), @see `file_source`.
+     */
+    class zstd_file_source
+    {
+    public:
+
+      zstd_file_source() = delete;
+      zstd_file_source(const zstd_file_source&) = delete;
+      zstd_file_source(zstd_file_source&&) = delete;
+      zstd_file_source& operator=(const zstd_file_source&) = delete;
+      zstd_file_source& operator=(zstd_file_source&&) = delete;
+
+      explicit zstd_file_source(const std::filesystem::path& path)
+      : fis_(path, std::ifstream::binary), dctx_(nullptr), input_(ZSTD_DStreamInSize()),
+        input_pos_(0), input_size_(0), eof_(false), frame_done_(true)
+      {
+        if(!fis_) throw std::runtime_error("Failed to open CSV file.");
+        dctx_ = ZSTD_createDCtx();
+        if(dctx_ == nullptr) throw std::runtime_error("Failed to decompress CSV file (zstd context).");
+      }
+
+      ~zstd_file_source() noexcept
+      { ZSTD_freeDCtx(dctx_); }
+
+      size_t read(char* const buffer, const size_t size)
+      {
+        auto output = ZSTD_outBuffer{buffer, size, 0};
+        while(output.pos < output.size) {
+          if((input_pos_ == input_size_) && (!eof_)) {
+            fis_.read(input_.data(), std::streamsize(input_.size()));
+            input_size_ = size_t(fis_.gcount());
+            input_pos_ = 0;
+            if((!fis_.good()) && (!fis_.eof())) throw std::runtime_error("Not all CSV file data could be read.");
+            eof_ = (input_size_ == 0);
+          }
+          auto input = ZSTD_inBuffer{input_.data(), input_size_, input_pos_};
+          const auto output_pos = output.pos;
+          const auto ret = ZSTD_decompressStream(dctx_, &output, &input);
+          if(ZSTD_isError(ret)) throw std::runtime_error(std::string("Failed to decompress CSV file (zstd): ") + ZSTD_getErrorName(ret));
+          const auto progress = (input.pos != input_pos_) || (output.pos != output_pos);
+          input_pos_ = input.pos;
+          if(progress) frame_done_ = (ret == 0); // Without progress, `ret` is only the next frame header size hint.
+          if(eof_ && (!progress)) {
+            // No more input, and all buffered data flushed.
+            if(!frame_done_) throw std::runtime_error("Failed to decompress CSV file (zstd): truncated data.");
+            break;
+          }
+        }
+        return output.pos;
+      }
+
+    private:
+
+      std::ifstream fis_;         // Compressed input file stream.
+      ZSTD_DCtx* dctx_;           // Decompression context.
+      std::vector<char> input_;   // Compressed input buffer.
+      size_t input_pos_;          // Decompressed position in `input_`.
+      size_t input_size_;         // Valid data size in `input_`.
+      bool eof_;                  // End of compressed input.
+      bool frame_done_;           // The last frame is completely decompressed and flushed.
+    };
+    #endif
+
+    /**
+     * File chunk reader with a background thread, which reads
+     * the next chunks into a small pool of recycled buffers
+     * while the current chunk is processed (I/O and parsing
+     * overlap). Read errors are forwarded by `acquire()`.
+     */
+    template<
+      typename StringType,              // Chunk buffer type, @concept: must be std::string like.
+      typename SourceType = file_source // Input source, @concept: constructible from the path, `size_t read(char*, size_t)` (@see `file_source`).
+    >
+    class basic_pipelined_file_reader
+    {
+    public:
+
+      using string_type = StringType;
+
+    public:
+
+      basic_pipelined_file_reader() = delete;
+      basic_pipelined_file_reader(const basic_pipelined_file_reader&) = delete;
+      basic_pipelined_file_reader(basic_pipelined_file_reader&&) = delete;
+      basic_pipelined_file_reader& operator=(const basic_pipelined_file_reader&) = delete;
+      basic_pipelined_file_reader& operator=(basic_pipelined_file_reader&&) = delete;
+
+      /**
+       * Opens the file and starts the reader thread.
+       *
+       * @param path File to read.
+       * @param chunk_size Buffer size.
+       * @param num_buffers Number of recycled chunk buffers (at least 2).
+       * @throw std::runtime_error
+       */
+      explicit basic_pipelined_file_reader(const std::filesystem::path& path, const size_t chunk_size, const size_t num_buffers)
+      : source_(path), chunk_size_(std::max(chunk_size, size_t(1))),
+        mutex_(), cv_(), free_(std::max(num_buffers, size_t(2))), filled_(), eof_(false), stop_(false),
+        error_(), thread_()
+      {
+        thread_ = std::thread([this](){ run(); });
+      }
+
+      ~basic_pipelined_file_reader() noexcept
+      {
+        {
+          const auto lock = std::lock_guard<std::mutex>(mutex_);
+          stop_ = true;
+        }
+        cv_.notify_all();
+        if(thread_.joinable()) thread_.join();
+      }
+
+    public:
+
+      /**
+       * Moves the next read chunk into `chunk` (waits until it
+       * is available), returns false at the end of the file.
+       * Return the chunk buffer with `release()` for reuse.
+       * @param string_type& chunk
+       * @return bool
+       * @throw std::exception
+       */
+      bool acquire(string_type& chunk)
+      {
+        auto lock = std::unique_lock<std::mutex>(mutex_);
+        cv_.wait(lock, [this](){ return (!filled_.empty()) || eof_; });
+        if(!filled_.empty()) {
+          chunk = std::move(filled_.front());
+          filled_.pop_front();
+          return true;
+        }
+        if(error_) std::rethrow_exception(error_);
+        return false;
+      }
+
+      /**
+       * Returns a chunk buffer to the pool.
+       * @param string_type&& chunk
+       */
+      void release(string_type&& chunk)
+      {
+        {
+          const auto lock = std::lock_guard<std::mutex>(mutex_);
+          free_.push_back(std::move(chunk));
+        }
+        cv_.notify_all();
+      }
+
+    private:
+
+      void run() noexcept
+      {
+        try {
+          for(auto done = false; !done;) {
+            auto chunk = string_type();
+            {
+              auto lock = std::unique_lock<std::mutex>(mutex_);
+              cv_.wait(lock, [this](){ return stop_ || (!free_.empty()); });
+              if(stop_) return;
+              chunk = std::move(free_.back());
+              free_.pop_back();
+            }
+            chunk.resize(chunk_size_);
+            auto n_read = size_t(0);
+            while((!done) && (n_read < chunk_size_)) {
+              const auto n = source_.read(chunk.data() + n_read, chunk_size_ - n_read); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+              n_read += n;
+              done = (n == 0);
+            }
+            {
+              const auto lock = std::lock_guard<std::mutex>(mutex_);
+              if(n_read > 0) {
+                chunk.resize(n_read);
+                filled_.push_back(std::move(chunk));
+              } else {
+                free_.push_back(std::move(chunk));
+              }
+              eof_ = done;
+            }
+            cv_.notify_all();
+          }
+        } catch(...) {
+          {
+            const auto lock = std::lock_guard<std::mutex>(mutex_);
+            error_ = std::current_exception();
+            eof_ = true;
+          }
+          cv_.notify_all();
+        }
+      }
+
+    private:
+
+      SourceType source_;                 // Input source, only used in the reader thread after construction.
+      const size_t chunk_size_;           // Chunk buffer size.
+      std::mutex mutex_;                  // Lock for the buffer queues and flags.
+      std::condition_variable cv_;        // Notification of queue and flag changes.
+      std::vector<string_type> free_;     // Buffers to be filled.
+      std::deque<string_type> filled_;    // Read chunks in file order.
+      bool eof_;                          // The reader thread has finished.
+      bool stop_;                         // Reader thread stop request.
+      std::exception_ptr error_;          // Reader thread error.
+      std::thread thread_;                // Reader thread, initialized last.
+    };
+
+    /**
+     * Byte classes of the CSV parsers (bit flags, a character
+     * can be e.g. delimiter and trim character at the same time).
+     */
+    enum char_class : uint8_t {
+      cc_other = 0x00,
+      cc_delimiter = 0x01,
+      cc_quote = 0x02,
+      cc_newline = 0x04,
+      cc_trim = 0x10,
+      cc_comment = 0x20
+    };
+
+    using char_class_table = std::array<uint8_t, 256>;
+
+    /**
+     * Returns the byte class lookup table for a CSV dialect,
+     * precomputed once per parser instance (or at compile time).
+     * The quote class is only set if `quoting` is enabled.
+     * @param const char delimiter
+     * @param const bool quoting
+     * @param const std::string_view comment_chars
+     * @param const std::string_view trim_chars
+     * @return char_class_table
+     */
+    constexpr char_class_table make_char_class_table(const char delimiter, const bool quoting, const std::string_view comment_chars, const std::string_view trim_chars) noexcept
+    {
+      auto table = char_class_table();
+      const auto add = [&table](const char c, const char_class cls){ table[uint8_t(c)] = uint8_t(table[uint8_t(c)] | cls); };
+      add('\r', cc_newline);
+      add('\n', cc_newline);
+      add(delimiter, cc_delimiter);
+      if(quoting) add('"', cc_quote);
+      for(const auto c: comment_chars) add(c, cc_comment);
+      for(const auto c: trim_chars) add(c, cc_trim);
+      return table;
+    }
+
+    /**
+     * Compile-time character set, e.g. `char_set<' ', '\t'>`.
+     */
+    template<char... Chars>
+    struct char_set
+    {
+      static constexpr size_t size = sizeof...(Chars);
+
+      static constexpr bool contains(const char c) noexcept
+      { return ((c == Chars) || ...); }
+
+      static constexpr std::string_view view() noexcept
+      { return std::string_view(chars_.data(), size); }
+
+    private:
+
+      static constexpr std::array<char, size + 1> chars_ = {Chars..., '\0'};
+    };
+
+    /**
+     * Run-time CSV dialect of the `basic_parser` (default):
+     * The delimiter, header comment characters, and trim
+     * characters are given as constructor arguments, and
+     * stored as byte class lookup table.
+     */
+    class dynamic_dialect
+    {
+    public:
+
+      static constexpr bool is_static = false;
+
+    public:
+
+      /**
+       * Dialect constructor.
+       * @param const char csv_delimiter
+       * @param const std::string_view header_comment_characters
+       * @param const std::string_view trim_characters
+       */
+      explicit dynamic_dialect(const char csv_delimiter, const std::string_view header_comment_characters, const std::string_view trim_characters) noexcept
+      : classes_(make_char_class_table(csv_delimiter, true, header_comment_characters, trim_characters)),
+        delimiter_(csv_delimiter), has_comment_chars_(!header_comment_characters.empty()), has_trim_chars_(!trim_characters.empty())
+      {}
+
+    public:
+
+      char delimiter() const noexcept { return delimiter_; }
+      static constexpr bool quoting() noexcept { return true; }
+      bool has_comment_chars() const noexcept { return has_comment_chars_; }
+      bool has_trim_chars() const noexcept { return has_trim_chars_; }
+      uint8_t char_class(const char c) const noexcept { return classes_[uint8_t(c)]; }
+      bool is_comment_char(const char c) const noexcept { return char_class(c) & cc_comment; }
+      bool is_trim_char(const char c) const noexcept { return char_class(c) & cc_trim; }
+
+    private:
+
+      char_class_table classes_;            // Byte class lookup table.
+      char delimiter_;                      // The CSV separator character.
+      bool has_comment_chars_;              // Header comment characters are defined.
+      bool has_trim_chars_;                 // Trim characters are defined.
+    };
+
+    /**
+     * Compile-time CSV dialect of the `basic_parser`: The
+     * delimiter, quoting (RFC4180 quoted fields on/off), and
+     * the header comment and trim `char_set`s are template
+     * parameters, so that the dialect checks in the parser
+     * are constant folded, and the byte class table is a
+     * constexpr table.
+     */
+    template<
+      char Delimiter,                         // The CSV separator character.
+      bool Quoting = true,                    // Quoted fields are recognized (otherwise quotes are normal characters).
+      typename CommentCharSet = char_set<>,   // Leading lines starting with one of the characters are ignored.
+      typename TrimCharSet = char_set<>       // Characters trimmed off at the start and end of each field.
+    >
+    struct static_dialect
+    {
+      static constexpr bool is_static = true;
+
+      static constexpr char delimiter() noexcept { return Delimiter; }
+      static constexpr bool quoting() noexcept { return Quoting; }
+      static constexpr bool has_comment_chars() noexcept { return CommentCharSet::size != 0; }
+      static constexpr bool has_trim_chars() noexcept { return TrimCharSet::size != 0; }
+      static constexpr uint8_t char_class(const char c) noexcept { return classes_[uint8_t(c)]; }
+      static constexpr bool is_comment_char(const char c) noexcept { return char_class(c) & cc_comment; }
+      static constexpr bool is_trim_char(const char c) noexcept { return char_class(c) & cc_trim; }
+
+    private:
+
+      static constexpr char_class_table classes_ = make_char_class_table(Delimiter, Quoting, CommentCharSet::view(), TrimCharSet::view());
+    };
+
+    /**
+     * Row offset index of a CSV file for random row access: Every
+     * `rows_per_entry` data rows, the byte offset and the number of
+     * lines before the row are recorded (quote-aware, built by the
+     * parser's `build_row_index()`). The index can be saved to and
+     * loaded from a sidecar text file, which also stores the CSV file
+     * size to detect (most) outdated indices.
+     */
+    class row_index
+    {
+    public:
+
+      /**
+       * Index entry: Data row number (0 to N-1), byte offset
+       * of the row start, and number of lines before the row.
+       */
+      struct entry_type { size_t row, offset, line_no; };
+
+    public:
+
+      row_index(const row_index&) = default;
+      row_index(row_index&&) noexcept = default;
+      row_index& operator=(const row_index&) = default;
+      row_index& operator=(row_index&&) noexcept = default;
+      ~row_index() noexcept = default;
+
+      /**
+       * Row index constructor.
+       * @param [rows_per_entry] Number of data rows between two index entries.
+       * @throws std::runtime_error
+       */
+      explicit row_index(const size_t rows_per_entry = 1024)
+      : entries_(), rows_per_entry_(rows_per_entry), num_rows_(), file_size_()
+      { if(rows_per_entry == 0) throw std::runtime_error("CSV row index needs at least one row per entry."); }
+
+    public:
+
+      size_t size() const noexcept { return entries_.size(); }
+      bool empty() const noexcept { return entries_.empty(); }
+      size_t rows_per_entry() const noexcept { return rows_per_entry_; }
+      size_t num_rows() const noexcept { return num_rows_; }
+      size_t file_size() const noexcept { return file_size_; }
+      const std::vector<entry_type>& entries() const noexcept { return entries_; }
+
+      /**
+       * Returns the last entry at or before the data row `row`
+       * (the index must not be empty).
+       * @param const size_t row
+       * @return const entry_type&
+       */
+      const entry_type& nearest_entry(const size_t row) const noexcept
+      { return entries_[std::min(row / rows_per_entry_, entries_.size() - 1)]; }
+
+      /**
+       * Removes all entries, the `rows_per_entry` setting is kept.
+       */
+      void clear() noexcept
+      { entries_.clear(); num_rows_ = 0; file_size_ = 0; }
+
+      /**
+       * Appends an entry (used while indexing).
+       * @param const entry_type& entry
+       */
+      void push_back(const entry_type& entry)
+      { entries_.push_back(entry); }
+
+      /**
+       * Sets the total number of data rows and the size of the
+       * indexed file (used at the end of indexing).
+       * @param const size_t num_rows
+       * @param const size_t file_size
+       */
+      void finish(const size_t num_rows, const size_t file_size) noexcept
+      { num_rows_ = num_rows; file_size_ = file_size; }
+
+      /**
+       * Saves the index to a sidecar text file. Throws on
+       * file writing errors.
+       * @param const std::filesystem::path& path
+       * @throws std::runtime_error
+       */
+      void save(const std::filesystem::path& path) const
+      {
+        auto fos = std::ofstream(path, std::ofstream::binary);
+        fos << "csv-row-index 1\n" << rows_per_entry_ << ' ' << num_rows_ << ' ' << file_size_ << ' ' << entries_.size() << '\n';
+        for(const auto& e: entries_) fos << e.row << ' ' << e.offset << ' ' << e.line_no << '\n';
+        fos.close();
+        if(!fos) throw std::runtime_error("Failed to write CSV row index file.");
+      }
+
+      /**
+       * Loads an index saved with `save()`. Throws on file
+       * reading errors or invalid index data.
+       * @param const std::filesystem::path& path
+       * @return row_index
+       * @throws std::runtime_error
+       */
+      static row_index load(const std::filesystem::path& path)
+      {
+        auto fis = std::ifstream(path, std::ifstream::binary);
+        if(!fis) throw std::runtime_error("Failed to open CSV row index file.");
+        auto magic = std::string();
+        auto version = 0;
+        auto rows_per_entry = size_t(0);
+        auto num_rows = size_t(0);
+        auto file_size = size_t(0);
+        auto num_entries = size_t(0);
+        fis >> magic >> version >> rows_per_entry >> num_rows >> file_size >> num_entries;
+        if((!fis) || (magic != "csv-row-index") || (version != 1) || (rows_per_entry == 0) || (num_entries != (num_rows + rows_per_entry - 1) / rows_per_entry)) {
+          throw std::runtime_error("Invalid CSV row index file.");
+        }
+        auto index = row_index(rows_per_entry);
+        index.entries_.resize(num_entries);
+        for(size_t i = 0; i < num_entries; ++i) {
+          auto& e = index.entries_[i];
+          fis >> e.row >> e.offset >> e.line_no;
+          if((!fis) || (e.row != i * rows_per_entry) || (e.offset > file_size) || ((i > 0) && (e.offset <= index.entries_[i-1].offset))) {
+            throw std::runtime_error("Invalid CSV row index file.");
+          }
+        }
+        index.finish(num_rows, file_size);
+        return index;
+      }
+
+    private:
+
+      std::vector<entry_type> entries_; // Entries of the rows 0, rows_per_entry, 2*rows_per_entry, ...
+      size_t rows_per_entry_;           // Number of data rows between two entries.
+      size_t num_rows_;                 // Total number of data rows in the indexed file.
+      size_t file_size_;                // Size of the indexed file in bytes.
+    };
+
+    /**
+     * Reason of a malformed row found by a validation scan.
+     */
+    enum class scan_error : uint8_t {
+      none,               // Not malformed.
+      column_count,       // The number of fields differs from the first data row.
+      data_after_quote,   // Characters between the closing quote of a field and the delimiter or line end.
+      unterminated_quote  // Quoted field not closed at the end of the input.
+    };
+
+    /**
+     * Result of a validation scan (@see `basic_parser::scan_file()`):
+     * Row and column counts, and the first malformed rows with their
+     * byte offsets and line numbers.
+     */
+    struct scan_result
+    {
+      /**
+       * Malformed row: Data row number (0 to N-1), byte offset of
+       * the row start, number of lines before the row, and reason.
+       */
+      struct malformed_row_type { size_t row, offset, line_no; scan_error error; };
+
+      size_t num_bytes = 0;                             // Total input size.
+      size_t num_rows = 0;                              // Number of data rows (header comments and empty lines are not counted).
+      size_t num_lines = 0;                             // Number of lines, including header comments and empty lines (as `line_no`, newlines in quoted fields are not counted).
+      size_t min_columns = 0;                           // Smallest number of fields in a row.
+      size_t max_columns = 0;                           // Largest number of fields in a row.
+      size_t num_malformed_rows = 0;                    // Number of malformed rows.
+      std::vector<malformed_row_type> malformed_rows;   // The first malformed rows (up to the maximum given to the scan).
+
+      bool valid() const noexcept { return num_malformed_rows == 0; }
+    };
+
+    /**
+     * Action when a row exceeds the parser memory limits (@see `row_limits`).
+     */
+    enum class limit_policy : uint8_t {
+      error,    // Throw a `std::runtime_error`.
+      skip_row  // Discard the row, parsing is resynchronized after the next line end.
+    };
+
+    /**
+     * Parser memory limits for single rows. Fields skipped by the
+     * column projection are not buffered, hence only counted for
+     * the number of fields. Default: No limits.
+     */
+    struct row_limits
+    {
+      size_t max_field_size = std::numeric_limits<size_t>::max(); // Largest buffered field (unescaped, before trimming the end).
+      size_t max_fields = std::numeric_limits<size_t>::max();     // Largest number of fields in a row (at least 1).
+      size_t max_row_size = std::numeric_limits<size_t>::max();   // Largest sum of the buffered field sizes in a row.
+      limit_policy policy = limit_policy::error;                   // Action when a limit is exceeded.
+    };
+
+    /**
+     * Parser statistics policy without counters (default). All
+     * hooks are empty, so that the calls in the parser hot path
+     * are optimized out.
+     */
+    struct no_parser_stats
+    {
+      static constexpr bool enabled = false;
+      void on_chunk(size_t) noexcept {}
+      void on_row(size_t, size_t) noexcept {}
+      void on_field(size_t) noexcept {}
+      void on_quoted_field() noexcept {}
+      void on_field_allocation() noexcept {}
+      void on_split_row() noexcept {}
+      void merge(const no_parser_stats&) noexcept {}
+    };
+
+    /**
+     * Parser statistics policy with counters, accumulated since
+     * construction or the last `clear()`. Sizes are in bytes,
+     * rows are counted without line endings. Field sizes are the
+     * (unescaped and trimmed) sizes of the fields passed to the row
+     * handler, fields skipped by the column projection are counted,
+     * but not measured. The counters can be read between `feed()`
+     * calls or in the row handler (mid-stream).
+     */
+    struct parser_stats
+    {
+      static constexpr bool enabled = true;
+
+      size_t num_chunks = 0;            // Number of data chunks fed or read.
+      size_t num_bytes = 0;             // Total size of the chunks.
+      size_t max_chunk_size = 0;        // Largest chunk.
+      size_t num_rows = 0;              // Number of data rows (header comments and empty lines are not counted).
+      size_t num_fields = 0;            // Number of fields in the data rows.
+      size_t num_quoted_fields = 0;     // Number of fields starting with a quote.
+      size_t max_field_size = 0;        // Largest field passed to the row handler.
+      size_t max_row_size = 0;          // Largest data row.
+      size_t max_row_fields = 0;        // Largest number of fields in a row.
+      size_t num_field_allocations = 0; // Field buffer capacity growths (stops increasing with a recycling container like `basic_field_pool`).
+      size_t num_split_rows = 0;        // Rows continued in the next chunk (carried over chunk boundaries).
+
+      void on_chunk(const size_t size) noexcept
+      { ++num_chunks; num_bytes += size; max_chunk_size = std::max(max_chunk_size, size); }
+
+      void on_row(const size_t fields, const size_t size) noexcept
+      { ++num_rows; num_fields += fields; max_row_fields = std::max(max_row_fields, fields); max_row_size = std::max(max_row_size, size); }
+
+      void on_field(const size_t size) noexcept
+      { max_field_size = std::max(max_field_size, size); }
+
+      void on_quoted_field() noexcept
+      { ++num_quoted_fields; }
+
+      void on_field_allocation() noexcept
+      { ++num_field_allocations; }
+
+      void on_split_row() noexcept
+      { ++num_split_rows; }
+
+      void merge(const parser_stats& o) noexcept
+      {
+        num_chunks += o.num_chunks; num_bytes += o.num_bytes; max_chunk_size = std::max(max_chunk_size, o.max_chunk_size);
+        num_rows += o.num_rows; num_fields += o.num_fields; num_quoted_fields += o.num_quoted_fields;
+        max_field_size = std::max(max_field_size, o.max_field_size); max_row_size = std::max(max_row_size, o.max_row_size);
+        max_row_fields = std::max(max_row_fields, o.max_row_fields); num_field_allocations += o.num_field_allocations;
+        num_split_rows += o.num_split_rows;
+      }
+
+      void clear() noexcept
+      { *this = parser_stats(); }
+    };
+
+    template<typename FieldContainer> class basic_named_row;
+
+    /**
+     * Column name to field index map, built once from the header
+     * row of a CSV file (@see `basic_parser::header_row()`). The
+     * indices refer to the field containers passed to the row
+     * handler, hence, the names of columns skipped by the column
+     * projection are not contained. For duplicate names, the first
+     * column is used.
+     */
+    class header_map
+    {
+    public:
+
+      static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    public:
+
+      header_map() = default;
+      header_map(header_map&&) noexcept = default;
+      header_map& operator=(header_map&&) noexcept = default;
+      ~header_map() noexcept = default;
+      header_map(const header_map& o) : names_(), index_() { assign(o.names_); }
+      header_map& operator=(const header_map& o) { if(&o != this) assign(o.names_); return *this; }
+
+      /**
+       * Constructs the map from the column names (in field order).
+       * @tparam typename NameContainer
+       * @param const NameContainer& names
+       */
+      template<typename NameContainer, typename = std::enable_if_t<!std::is_same<std::decay_t<NameContainer>, header_map>::value>>
+      explicit header_map(const NameContainer& names) : names_(), index_()
+      { assign(names); }
+
+    public:
+
+      size_t size() const noexcept { return names_.size(); }
+      bool empty() const noexcept { return names_.empty(); }
+      const std::vector<std::string>& names() const noexcept { return names_; }
+
+      /**
+       * Returns the name of the field index `index`.
+       * @param const size_t index
+       * @return const std::string&
+       */
+      const std::string& name(const size_t index) const
+      { return names_.at(index); }
+
+      /**
+       * Returns the field index (0 to N-1) of the column
+       * `name`, or `npos` if the name is not in the header.
+       * @param const std::string_view name
+       * @return size_t
+       */
+      size_t index_of(const std::string_view name) const noexcept
+      { const auto it = index_.find(name); return (it == index_.end()) ? npos : it->second; }
+
+      /**
+       * Returns true if the header contains the column `name`.
+       * @param const std::string_view name
+       * @return bool
+       */
+      bool contains(const std::string_view name) const noexcept
+      { return index_.find(name) != index_.end(); }
+
+      /**
+       * Returns the field index (0 to N-1) of the column `name`,
+       * throws if the name is not in the header. Lookups can be
+       * done once, and the index used for all rows.
+       * @param const std::string_view name
+       * @return size_t
+       * @throws std::runtime_error
+       */
+      size_t column(const std::string_view name) const
+      {
+        const auto index = index_of(name);
+        if(index == npos) throw std::runtime_error("CSV column name not found in header.");
+        return index;
+      }
+
+      /**
+       * Clears the names and the index.
+       */
+      void clear() noexcept
+      { index_.clear(); names_.clear(); }
+
+      /**
+       * Replaces the names and rebuilds the index.
+       * @tparam typename NameContainer
+       * @param const NameContainer& names
+       */
+      template<typename NameContainer>
+      void assign(const NameContainer& names)
+      {
+        clear();
+        for(const auto& name:names) names_.emplace_back(name);
+        index_.reserve(names_.size());
+        for(size_t i = 0; i < names_.size(); ++i) index_.emplace(std::string_view(names_[i]), i); // Keeps the first of duplicate names.
+      }
+
+      /**
+       * Returns a named access wrapper for the fields of a row.
+       * @tparam typename FieldContainer
+       * @param const FieldContainer& fields
+       * @return basic_named_row<FieldContainer>
+       */
+      template<typename FieldContainer>
+      basic_named_row<FieldContainer> row(const FieldContainer& fields) const noexcept
+      { return basic_named_row<FieldContainer>(fields, *this); }
+
+    private:
+
+      std::vector<std::string> names_;                        // Column names in field order.
+      std::unordered_map<std::string_view, size_t> index_;    // Name to field index, the views refer to `names_`.
+    };
+
+    /**
+     * Lightweight row reference with field access by index
+     * or by column name (@see `header_map::row()`). Does not
+     * copy the fields, only valid in the row handler.
+     */
+    template<typename FieldContainer>
+    class basic_named_row
+    {
+    public:
+
+      using container_type = FieldContainer;
+      using value_type = typename container_type::value_type;
+
+    public:
+
+      basic_named_row(const container_type& fields, const header_map& header) noexcept : fields_(fields), header_(header) {}
+
+    public:
+
+      size_t size() const noexcept { return fields_.size(); }
+      bool empty() const noexcept { return fields_.size() == 0; }
+      const container_type& fields() const noexcept { return fields_; }
+      const header_map& header() const noexcept { return header_; }
+      const value_type& operator[](const size_t index) const { return fields_[index]; }
+
+      /**
+       * Returns true if the row has the field of the column `name`
+       * (the name is in the header, and the row is long enough).
+       * @param const std::string_view name
+       * @return bool
+       */
+      bool contains(const std::string_view name) const noexcept
+      { return header_.index_of(name) < fields_.size(); }
+
+      /**
+       * Returns the field of the column `name`, throws if the name
+       * is not in the header, or if the row has less fields.
+       * @param const std::string_view name
+       * @return const value_type&
+       * @throws std::runtime_error
+       */
+      const value_type& field(const std::string_view name) const
+      {
+        const auto index = header_.column(name);
+        if(index >= fields_.size()) throw std::runtime_error("CSV row has no field for the column name.");
+        return fields_[index];
+      }
+
+      const value_type& operator[](const std::string_view name) const
+      { return field(name); }
+
+    private:
+
+      const container_type& fields_;
+      const header_map& header_;
+    };
+
+    /**
+     * CSV parser class template, tune your performance
+     * vs memory consumption via `ReadBufferSizeKb`, which
+     * has a notable performance impact due to stream
+     * reading.
+     * With a `StringContainerType` of string views (view mode,
+     * e.g. `csv_view_parser`), the row handler gets views instead
+     * of copied fields: Fields contiguous in the input data refer
+     * directly to it, only escaped fields and the fields of a row
+     * continued in the next chunk are copied into an internal line
+     * buffer. The views are valid until the row handler returns.
+     */
+    template<
+      size_t ReadBufferSizeKb,      // File reading chunk size.
+      typename StringType,          // String type used, @concept: must be std::string like.
+      typename StringContainerType, // Container<String> type used, @concept: must be ramdom access and StringType (copied fields) or basic_string_view<char> (views) as value_type.
+      typename RowHandlerType = std::function<void(const StringContainerType& fields, size_t line_no)>, // Row handler type, @concept: const-invocable with `(const StringContainerType&, size_t)`.
+      typename DialectType = dynamic_dialect, // CSV dialect, @concept: `dynamic_dialect` or `static_dialect`.
+      typename StatsType = no_parser_stats    // Statistics policy, @concept: `no_parser_stats` or `parser_stats` like.
+    >
+    class basic_parser
+    {
+    public:
+
+      using string_type = StringType;
+      using char_type = typename string_type::value_type;
+      using string_view_type = std::basic_string_view<char_type>;
+      using string_container_type = StringContainerType;
+      using row_handler_type = RowHandlerType;
+      using dialect_type = DialectType;
+      using stats_type = StatsType;
+      using oversize_field_handler_type = std::function<void(string_view_type data, size_t row, size_t col, bool last)>;
+
+      static constexpr size_t read_buffer_size_kb = ReadBufferSizeKb;
+      static constexpr size_t read_buffer_alignment = 4096; // Read buffer sizes are multiples of the (typical) page size.
+      static constexpr bool is_view_parser = std::is_same<string_view_type, typename string_container_type::value_type>::value; // View mode.
+
+    public:
+
+      basic_parser() = delete;
+      basic_parser(const basic_parser&) = delete;
+      basic_parser(basic_parser&&) noexcept = default;
+      basic_parser& operator=(const basic_parser&) = delete;
+      basic_parser& operator=(basic_parser&&) noexcept = default;
+      ~basic_parser() noexcept = default;
+
+      /**
+       * CSV parser constructor (run-time dialect).
+       *
+       * @param on_row Function invoked for each CSV row.
+       * @param [csv_delimiter] The CSV separator character.
+       * @param [header_comment_characters] Leading lines starting with one of the characters in the string will be ignored.
+       * @param [trim_characters] Characters to be trimmed off at the start and end of each field (CSV entry). Whitespaces are often trimmed.
+       */
+      template<typename D = dialect_type, typename std::enable_if<!D::is_static, int>::type = 0>
+      explicit basic_parser(
+        const row_handler_type on_row,
+        const char_type csv_delimiter = ',',
+        const string_view_type header_comment_characters = string_view_type(""),
+        const string_view_type trim_characters = string_view_type("")
+      )
+      : basic_parser(on_row, dialect_type(csv_delimiter, header_comment_characters, trim_characters))
+      {}
+
+      /**
+       * CSV parser constructor (compile-time dialect, the
+       * settings are given by the `static_dialect` type).
+       *
+       * @param on_row Function invoked for each CSV row.
+       */
+      template<typename D = dialect_type, typename std::enable_if<D::is_static, int>::type = 0>
+      explicit basic_parser(const row_handler_type on_row)
+      : basic_parser(on_row, dialect_type())
+      {}
+
+    private:
+
+      explicit basic_parser(const row_handler_type on_row, const dialect_type dialect)
+      : row_handler_(on_row),
+        dialect_(dialect),
+        selected_columns_(),
+        selected_column_names_(),
+        header_(),
+        limits_(),
+        oversize_field_handler_(),
+        current_line_(),
+        current_field_(),
+        escaped_(),
+        escaped_fields_(),
+        owned_fields_(),
+        col_(),
+        row_size_(),
+        skipped_chars_(),
+        streaming_field_(),
+        state_(parse_state::line_start),
+        line_no_(),
+        n_rows_(),
+        offset_(),
+        row_offset_(),
+        row_line_no_(),
+        row_range_first_(),
+        row_range_end_(std::numeric_limits<size_t>::max()),
+        row_index_(),
+        scan_(),
+        max_malformed_rows_(),
+        first_row_columns_(),
+        row_error_(scan_error::none),
+        n_skipped_rows_(),
+        read_buffer_size_(aligned_read_buffer_size(read_buffer_size_kb * 1024)),
+        read_buffer_size_min_(read_buffer_size_),
+        read_buffer_size_max_(read_buffer_size_),
+        read_buffer_(),
+        stats_()
+      {
+        // Support for < c++20: Explicit checks, no use of concepts yet:
+        static_assert(std::is_same<string_type, typename string_container_type::value_type>::value || is_view_parser, "StringContainerType has to have StringType or basic_string_view<char> as elements.");
+        static_assert(std::is_default_constructible<string_container_type>::value, "StringContainerType must be a default-constructible dynamic sized container.");
+        // Also: wstring not needed by anyone, string with custom allocator maybe:
+        static_assert(std::is_same<char, char_type>::value, "wstring not supported. Widen/narrow in your code.");
+        static_assert(std::is_invocable<const row_handler_type&, const string_container_type&, size_t>::value, "RowHandlerType must be const-invocable with (const StringContainerType&, size_t).");
+      }
+
+    public:
+
+      /**
+       * Clears the internal state (but not the
+       * construction settings), so that a new
+       * CSV data set can be processed.
+       * @return basic_parser&
+       */
+      basic_parser& clear()
+      {
+        current_line_.clear();
+        current_field_.clear();
+        escaped_.clear();
+        escaped_fields_.clear();
+        owned_fields_ = 0;
+        col_ = 0;
+        row_size_ = 0;
+        skipped_chars_ = false;
+        streaming_field_ = false;
+        state_ = parse_state::line_start;
+        line_no_ = 0;
+        n_rows_ = 0;
+        offset_ = 0;
+        row_offset_ = 0;
+        row_line_no_ = 0;
+        row_error_ = scan_error::none;
+        n_skipped_rows_ = 0;
+        return *this;
+      }
+
+      /**
+       * Column projection: Defines which columns (indexing 1 to N,
+       * not 0 to N-1) are passed to the row handler, in the order
+       * of the CSV columns. The fields of other columns are skipped
+       * without copying, trimming or unescaping (quotes are still
+       * tracked). Rows not containing any of the selected columns
+       * are passed with no fields. An empty index container selects
+       * all columns (default). With a container of column names, the
+       * first data row of each parsed file is the header row, in which
+       * the indices are looked up (independent of the order of this call
+       * and `header_row()`, which is optional here). Unknown names throw
+       * when the header row is parsed.
+       * @tparam typename IndexContainer
+       * @param const IndexContainer& column_indices
+       * @return basic_parser&
+       * @throws std::runtime_error
+       */
+      template<typename IndexContainer>
+      basic_parser& select_columns(const IndexContainer& column_indices)
+      {
+        using value_type = std::decay_t<decltype(*std::begin(column_indices))>;
+        if constexpr(std::is_convertible<value_type, string_view_type>::value) {
+          auto names = std::vector<string_type>();
+          for(const auto& name:column_indices) names.emplace_back(string_view_type(name));
+          selected_column_names_.swap(names);
+          selected_columns_.clear(); // Resolved when the header row is parsed.
+        } else {
+          auto selected = std::vector<char>();
+          for(const auto& i:column_indices) {
+            if(i <= 0) throw std::runtime_error("CSV column index out of range (use 1 to N).");
+            if(size_t(i) > selected.size()) selected.resize(size_t(i), 0);
+            selected[size_t(i-1)] = 1;
+          }
+          selected_columns_.swap(selected);
+          selected_column_names_.clear();
+        }
+        return *this;
+      }
+
+      /**
+       * Header row: The first data row (after header comments) of
+       * each parsed CSV text or file is not passed to the row handler,
+       * but its (unescaped and trimmed) fields are stored in `header`,
+       * which maps the column names to the field indices of the rows
+       * passed to the row handler. The header row is still counted as
+       * data row 0 for row indices. The map is owned by the caller and
+       * must outlive the parsing, `nullptr` disables the header row
+       * (unless columns are selected by name).
+       * @param header_map* header
+       * @return basic_parser&
+       */
+      basic_parser& header_row(header_map* header) noexcept
+      { header_ = header; return *this; }
+
+      /**
+       * Sets the file reading chunk size in bytes (rounded up to
+       * a multiple of `read_buffer_alignment`). The initial size
+       * is `ReadBufferSizeKb`, also rounded up. Disables adaptive
+       * sizing.
+       * @param const size_t size
+       * @return basic_parser&
+       * @throws std::runtime_error
+       */
+      basic_parser& read_buffer_size(const size_t size)
+      { return adaptive_read_buffer_size(size, size); }
+
+      /**
+       * Enables adaptive file reading chunk sizes between `min_size`
+       * and `max_size` (rounded up to multiples of `read_buffer_alignment`):
+       * After each chunk of `parse_file()`, the size is doubled when
+       * reading took longer than parsing (high latency sources like
+       * network file systems or pipes), and halved when reading was
+       * more than four times faster than parsing (cached files, where
+       * smaller chunks stay in the CPU cache). The adapted size is kept
+       * for subsequent files. Equal sizes disable adaptive sizing.
+       * @param const size_t min_size
+       * @param const size_t max_size
+       * @return basic_parser&
+       * @throws std::runtime_error
+       */
+      basic_parser& adaptive_read_buffer_size(const size_t min_size, const size_t max_size)
+      {
+        if((min_size == 0) || (min_size > max_size)) throw std::runtime_error("Invalid CSV read buffer size.");
+        read_buffer_size_min_ = aligned_read_buffer_size(min_size);
+        read_buffer_size_max_ = aligned_read_buffer_size(max_size);
+        read_buffer_size_ = std::clamp(read_buffer_size_, read_buffer_size_min_, read_buffer_size_max_);
+        return *this;
+      }
+
+      /**
+       * Returns the current file reading chunk size in bytes.
+       * @return size_t
+       */
+      size_t read_buffer_size() const noexcept
+      { return read_buffer_size_; }
+
+      /**
+       * Returns true if the file reading chunk size is adapted.
+       * @return bool
+       */
+      bool is_adaptive_read_buffer_size() const noexcept
+      { return read_buffer_size_min_ != read_buffer_size_max_; }
+
+      /**
+       * Memory limits for pathological rows (@see `row_limits`), e.g. an
+       * unterminated quote, which would otherwise buffer the rest of the
+       * input as one field. Data exceeding a limit are not buffered: The
+       * parser throws (`limit_policy::error`), or discards the row and
+       * resumes after the next line end, even if the limit was exceeded
+       * in a quoted field (`limit_policy::skip_row`). Discarded rows are
+       * not counted as data rows (@see `num_skipped_rows()`).
+       * @param const row_limits& limits
+       * @return basic_parser&
+       */
+      basic_parser& limits(const row_limits& limits)
+      { limits_ = limits; return *this; }
+
+      /**
+       * Returns the current row memory limits.
+       * @return const row_limits&
+       */
+      const row_limits& limits() const noexcept
+      { return limits_; }
+
+      /**
+       * Streams fields exceeding `row_limits::max_field_size` to
+       * `handler(data, row, col, last)` in pieces instead of applying
+       * the limit policy (zero-based data row and column index, `last`
+       * is true for the final, possibly empty, piece). The streamed
+       * field is passed empty to the row handler, trailing trim
+       * characters are not removed. An empty handler disables it.
+       * @param oversize_field_handler_type handler
+       * @return basic_parser&
+       */
+      basic_parser& oversize_field_handler(oversize_field_handler_type handler)
+      { oversize_field_handler_ = std::move(handler); return *this; }
+
+      /**
+       * Returns the number of rows discarded by the `limit_policy::skip_row`
+       * policy since construction or the last `clear()`.
+       * @return size_t
+       */
+      size_t num_skipped_rows() const noexcept
+      { return n_skipped_rows_; }
+
+      /**
+       * Partial CSV parsing, invokes `row_handler` directly
+       * when a data line is completed. Leaves unfinished line
+       * data in the internal buffer for the next feed cycle.
+       * Use `finish()` to ensure that the last line of file
+       * or stream is not lost. The data are parsed in place,
+       * the caller keeps the ownership (the end is determined
+       * by the length, no terminating character is appended).
+       * @param const string_view_type csv_text
+       * @return basic_parser&
+       */
+      basic_parser& feed(const string_view_type csv_text)
+      { stats_.on_chunk(csv_text.size()); return push(csv_text); }
+
+      /**
+       * Adds the internally buffered line in case there is no
+       * trailing newline in the CSV data before end of input.
+       * Use `finish()` after all data have been processed using
+       * `feed()`. This method is not automatically invoked in
+       * the destructor, as the (your) `row_handler` may throw.
+       * @return basic_parser&
+       */
+      basic_parser& finish()
+      {
+        // A quoted field is closed at the end of the input.
+        if((scan_ != nullptr) && (state_ == parse_state::quoted) && (row_error_ == scan_error::none)) row_error_ = scan_error::unterminated_quote;
+        if((state_ == parse_state::quoted) || (state_ == parse_state::quoted_quote)) state_ = parse_state::unquoted;
+        const auto offset = offset_; // The terminating newline is not part of the input.
+        const auto line_no = line_no_;
+        const auto pending = (state_ != parse_state::line_start) && (state_ != parse_state::after_cr);
+        push("\n");
+        offset_ = offset;
+        if(!pending) line_no_ = line_no; // Nor a line, if there is no unterminated line.
+        return *this;
+      }
+
+      /**
+       * Parses and finishes (@see `feed()` and `finish()`) a
+       * complete CSV text.
+       * @param const string_view_type csv_text
+       */
+      void parse(const string_view_type csv_text)
+      { clear(); feed(csv_text); finish(); }
+
+      /**
+       * Parses and finishes a complete CSV text passed as owned
+       * (moved) string. For compatibility with the former string
+       * based API, the text ends at the first `'\0'`, if any (the
+       * string view overloads parse a `'\0'` as field data). Not
+       * in view mode, where the string view overload is used.
+       * @param string_type&& csv_text
+       */
+      template<typename S, typename std::enable_if<std::is_same<S, string_type>::value && !is_view_parser, int>::type = 0>
+      void parse(S&& csv_text)
+      { parse(string_view_type(csv_text).substr(0, csv_text.find(char_type(0)))); }
+
+      /**
+       * Reads and parses a CSV (regular) file given by
+       * its filesystem path. The file is memory mapped
+       * and parsed in place where possible, otherwise it
+       * is read in chunks of `read_buffer_size()`. Throws
+       * on file reading or memory errors.
+       *
+       * @param const std::filesystem::path& path
+       * @throw std::exception
+       */
+      void parse_file(const std::filesystem::path& path)
+      { clear(); read_file(path, 0); }
+
+      /**
+       * Reads and parses the data rows `first_row` to
+       * `first_row+num_rows-1` (0 to N-1, header comments and
+       * empty lines are not counted) of a CSV file, starting at
+       * the nearest entry of a row index built for this file
+       * with the same parser settings (@see `build_row_index()`).
+       * The `line_no` arguments are the same as for `parse_file()`.
+       * With a header row or a column selection by name, the
+       * header row is read first. Reading stops after the last
+       * requested row. Throws on file reading or memory errors,
+       * or if the file size does not match the index.
+       *
+       * @param const std::filesystem::path& path
+       * @param const row_index& index
+       * @param const size_t first_row
+       * @param const size_t num_rows
+       * @throw std::exception
+       */
+      void parse_file(const std::filesystem::path& path, const row_index& index, const size_t first_row, const size_t num_rows)
+      {
+        clear();
+        if(size_t(std::filesystem::file_size(path)) != index.file_size()) {
+          throw std::runtime_error("CSV row index does not match the file.");
+        }
+        if((first_row >= index.num_rows()) || (num_rows == 0)) return;
+        const auto& entry = index.nearest_entry(first_row);
+        try {
+          if(is_header_row() && (entry.row > 0)) {
+            // The header row (column names, header map) is read from the file start before seeking.
+            row_range_end_ = 1;
+            read_file(path, 0);
+            clear();
+          }
+          line_no_ = entry.line_no;
+          n_rows_ = entry.row;
+          row_range_first_ = first_row;
+          row_range_end_ = first_row + std::min(num_rows, index.num_rows() - first_row);
+          read_file(path, entry.offset);
+        } catch(...) {
+          row_range_first_ = 0;
+          row_range_end_ = std::numeric_limits<size_t>::max();
+          throw;
+        }
+        row_range_first_ = 0;
+        row_range_end_ = std::numeric_limits<size_t>::max();
+      }
+
+      /**
+       * Builds the row offset index of a CSV file: Reads the
+       * file like `parse_file()`, but instead of invoking the row
+       * handler (and without copying fields), the byte offset and
+       * line count of every `rows_per_entry`th data row are recorded.
+       * Throws on file reading or memory errors.
+       *
+       * @param const std::filesystem::path& path
+       * @param const size_t rows_per_entry
+       * @return row_index
+       * @throw std::exception
+       */
+      row_index build_row_index(const std::filesystem::path& path, const size_t rows_per_entry = 1024)
+      {
+        auto index = row_index(rows_per_entry);
+        auto selected = std::vector<char>(1, 0); // No column selected, all fields are skipped.
+        selected_columns_.swap(selected);
+        row_index_ = &index;
+        try {
+          parse_file(path);
+        } catch(...) {
+          row_index_ = nullptr;
+          selected_columns_.swap(selected);
+          throw;
+        }
+        row_index_ = nullptr;
+        selected_columns_.swap(selected);
+        index.finish(n_rows_, offset_);
+        return index;
+      }
+
+      /**
+       * Validation scan of a CSV file: Reads the file like `parse_file()`
+       * with the same tokenizer, but without copying fields or invoking
+       * the row handler, and counts rows, lines and the min/max number
+       * of fields per row. Rows with another number of fields than the
+       * first data row, with data after the closing quote of a field,
+       * or with an unterminated quoted field are counted as malformed,
+       * the first `max_malformed_rows` are recorded. Throws on file
+       * reading or memory errors (not for malformed data).
+       *
+       * @param const std::filesystem::path& path
+       * @param const size_t max_malformed_rows
+       * @return scan_result
+       * @throw std::exception
+       */
+      scan_result scan_file(const std::filesystem::path& path, const size_t max_malformed_rows = 16)
+      { return scan_input([&](){ parse_file(path); }, max_malformed_rows); }
+
+      /**
+       * Validation scan of a complete CSV text (@see `scan_file()`).
+       * @param const string_view_type csv_text
+       * @param const size_t max_malformed_rows
+       * @return scan_result
+       */
+      scan_result scan(const string_view_type csv_text, const size_t max_malformed_rows = 16)
+      { return scan_input([&](){ parse(csv_text); }, max_malformed_rows); }
+
+      /**
+       * Reads and parses a CSV file as `parse_file()`, but the
+       * file is read in a background thread, which fills the
+       * next chunk buffers (`num_buffers` recycled buffers of
+       * `read_buffer_size()`) while the current chunk is
+       * parsed. The row handler is invoked in the calling thread.
+       *
+       * @param const std::filesystem::path& path
+       * @param const size_t num_buffers
+       * @throw std::exception
+       */
+      void parse_file_pipelined(const std::filesystem::path& path, const size_t num_buffers = 3)
+      { parse_pipelined<file_source>(path, num_buffers); }
+
+      /**
+       * Reads and parses a gzip or zstd compressed CSV file (or
+       * a plain CSV file), as `parse_file_pipelined()`. The file
+       * is decompressed in the reader thread directly into the
+       * chunk buffers. The format is determined by the magic bytes
+       * of the file, decompression support is opt-in by defining
+       * `WITH_CSV_ZLIB` (link `-lz`) and/or `WITH_CSV_ZSTD` (link
+       * `-lzstd`) before including `csv.hh`. Throws for compressed
+       * files if the corresponding support is not enabled.
+       *
+       * @param const std::filesystem::path& path
+       * @param const size_t num_buffers
+       * @throw std::exception
+       */
+      void parse_compressed_file(const std::filesystem::path& path, const size_t num_buffers = 3)
+      {
+        switch(compression_of(path)) {
+          case file_compression::gzip:
+            #if defined(WITH_CSV_ZLIB)
+            return parse_pipelined<gzip_file_source>(path, num_buffers);
+            #else
+            throw std::runtime_error("CSV file is gzip compressed, but zlib support is not enabled (WITH_CSV_ZLIB).");
+            #endif
+          case file_compression::zstd:
+            #if defined(WITH_CSV_ZSTD)
+            return parse_pipelined<zstd_file_source>(path, num_buffers);
+            #else
+            throw std::runtime_error("CSV file is zstd compressed, but zstd support is not enabled (WITH_CSV_ZSTD).");
+            #endif
+          case file_compression::none:
+          default:
+            return parse_pipelined<file_source>(path, num_buffers);
+        }
+      }
+
+      /**
+       * Parses a CSV (regular) file on multiple threads. The
+       * memory mapped file is split into `num_threads` byte
+       * ranges, a parallel pre-scan determines the exact quote
+       * state and line count at the range boundaries, and the
+       * rows starting in each range are parsed on one thread
+       * (with the settings of this parser). The header row is
+       * parsed first (if any, @see `header_row()`). The row
+       * handler is invoked concurrently (rows of one range in
+       * order), hence, it must be thread-safe. The `line_no`
+       * arguments are the same as for `parse_file()`, the `row`
+       * arguments of the oversize field handler count the rows
+       * of each range. The statistics of the ranges are merged.
+       * Files which cannot be mapped, or which are too small to
+       * split into ranges of at least `read_buffer_size()`, are
+       * parsed with `parse_file()`. Throws on file reading or
+       * memory errors, and rethrows row handler exceptions.
+       *
+       * @param const std::filesystem::path& path
+       * @param size_t [num_threads] Number of threads, 0 = hardware concurrency.
+       * @throw std::exception
+       */
+      void parse_file_parallel(const std::filesystem::path& path, size_t num_threads = 0)
+      {
+        using namespace std;
+        clear();
+        const auto mapped = mapped_file(path);
+        if(num_threads == 0) num_threads = size_t(thread::hardware_concurrency());
+        const auto n = std::min(num_threads, mapped.size() / read_buffer_size_);
+        if((!mapped.is_open()) || (n < 2)) {
+          parse_file(path);
+          return;
+        }
+
+        const auto run_parallel = [n](const auto& fn){
+          auto errors = vector<exception_ptr>(n);
+          auto threads = vector<thread>();
+          threads.reserve(n - 1);
+          try {
+            for(size_t k = 1; k < n; ++k) {
+              threads.emplace_back([&fn, &errors, k](){
+                try { fn(k); } catch(...) { errors[k] = current_exception(); }
+              });
+            }
+          } catch(...) {
+            for(auto& t: threads) t.join();
+            throw;
+          }
+          try { fn(0); } catch(...) { errors[0] = current_exception(); }
+          for(auto& t: threads) t.join();
+          for(const auto& e: errors) {
+            if(e) rethrow_exception(e);
+          }
+        };
+
+        // Header comments and the header row are parsed sequentially, the data are split into ranges.
+        const auto classes = range_char_classes();
+        const auto end = mapped.data() + mapped.size();
+        auto data = mapped.data();
+        while(data != end) {
+          if((*data == '\n') || (*data == '\r')) {
+            ++line_no_;
+            if((*data++ == '\r') && (data != end) && (*data == '\n')) ++data;
+          } else if(dialect_.has_comment_chars() && dialect_.is_comment_char(*data)) {
+            data = find_first_of(data, end, array<char_type, 2>{'\r', '\n'});
+          } else {
+            break;
+          }
+        }
+        if(is_header_row() && (data != end)) {
+          const auto header_end = find_range_row_end(data, end, rs_row_start, classes);
+          const auto header = string_view_type(data, size_t(header_end - data));
+          offset_ = size_t(data - mapped.data());
+          push(header);
+          data = header_end;
+          if((data != end) && (data[-1] == '\r') && (*data == '\n')) ++data;
+        }
+        if(data != mapped.data()) stats_.on_chunk(size_t(data - mapped.data()));
+        if(data == end) { finish(); return; }
+        auto range_begin = vector<const char_type*>(n + 1);
+        for(size_t k = 0; k <= n; ++k) range_begin[k] = data + size_t(end - data) / n * k;
+        range_begin[n] = end;
+
+        // Speculative pass: range end states and line counts for all possible range start states.
+        auto range_scans = vector<range_scan_type>(n);
+        run_parallel([&](size_t k){ range_scans[k] = scan_range(range_begin[k], range_begin[k + 1], classes); });
+
+        // Fix-up: Exact state at each range start, and the first row starting in the range.
+        auto row_begin = vector<const char_type*>(n + 1, end);
+        auto row_line_no = vector<size_t>(n);
+        auto row_skip_lf = vector<bool>(n);
+        auto state = uint8_t(rs_row_start);
+        for(size_t k = 0; k < n; ++k) {
+          row_line_no[k] = line_no_;
+          if((state == rs_row_start) || (state == rs_row_start_cr)) {
+            row_begin[k] = range_begin[k];
+            row_skip_lf[k] = (state == rs_row_start_cr);
+          } else {
+            row_begin[k] = find_range_row_end(range_begin[k], end, state, classes);
+            row_skip_lf[k] = (row_begin[k] != end) && (*(row_begin[k] - 1) == '\r');
+            if(row_begin[k] != end) ++row_line_no[k];
+          }
+          line_no_ += range_scans[k].n_lines[state];
+          state = range_scans[k].end_state[state];
+        }
+
+        // Parallel parsing of the rows starting in each range.
+        auto range_rows = vector<size_t>(n);
+        auto range_skipped_rows = vector<size_t>(n);
+        auto range_stats = vector<stats_type>(n);
+        auto last_line_no = line_no_;
+        run_parallel([&](size_t k){
+          auto parser = basic_parser(row_handler_, dialect_);
+          parser.selected_columns_ = selected_columns_;
+          parser.limits_ = limits_;
+          parser.oversize_field_handler_ = oversize_field_handler_;
+          parser.line_no_ = row_line_no[k];
+          parser.n_rows_ = 1; // Neither header comments nor the header row in the ranges.
+          parser.offset_ = size_t(row_begin[k] - mapped.data());
+          if(row_skip_lf[k]) parser.state_ = parse_state::after_cr;
+          const auto last = (k + 1 == n);
+          const auto range = string_view_type(row_begin[k], size_t((last ? end : row_begin[k + 1]) - row_begin[k]));
+          parser.stats_.on_chunk(range.size());
+          parser.push(range);
+          if(last) {
+            parser.finish();
+            last_line_no = parser.line_no_;
+          } else if((parser.state_ != parse_state::line_start) && (parser.state_ != parse_state::after_cr)) {
+            throw runtime_error("CSV parallel parsing range boundary mismatch.");
+          }
+          range_rows[k] = parser.n_rows_ - 1;
+          range_skipped_rows[k] = parser.n_skipped_rows_;
+          range_stats[k] = parser.stats_;
+        });
+        n_rows_ += std::accumulate(range_rows.begin(), range_rows.end(), size_t(0));
+        n_skipped_rows_ += std::accumulate(range_skipped_rows.begin(), range_skipped_rows.end(), size_t(0));
+        for(const auto& stats: range_stats) stats_.merge(stats);
+        line_no_ = last_line_no;
+        offset_ = mapped.size();
+      }
+
+      /**
+       * Returns the statistics policy object (@see `parser_stats`),
+       * which is not reset by `clear()`. With the default policy
+       * `no_parser_stats`, nothing is counted.
+       * @return const stats_type&
+       */
+      const stats_type& stats() const noexcept
+      { return stats_; }
+
+      /**
+       * Returns the statistics policy object, e.g. to
+       * reset the counters between data sets.
+       * @return stats_type&
+       */
+      stats_type& stats() noexcept
+      { return stats_; }
+
+    protected:
+
+      /**
+       * Reads and parses a CSV file from the byte offset `offset`
+       * to the end, or until the end of the row range is reached.
+       * Mapped files are parsed in place, in slices of the read
+       * buffer size (so that row ranges end early), other files
+       * are read into the read buffer. The parser state is not
+       * cleared.
+       * @param const std::filesystem::path& path
+       * @param const size_t offset
+       */
+      void read_file(const std::filesystem::path& path, const size_t offset)
+      {
+        using namespace std;
+        {
+          const auto mapped = mapped_file(path);
+          if(mapped.is_open()) {
+            const auto data = string_view_type(mapped.data(), mapped.size());
+            offset_ = std::min(offset, data.size());
+            for(auto pos = offset_; (pos < data.size()) && (n_rows_ < row_range_end_); pos += read_buffer_size_) {
+              const auto chunk = data.substr(pos, read_buffer_size_);
+              stats_.on_chunk(chunk.size());
+              push(chunk);
+            }
+            finish();
+            return;
+          }
+        }
+        auto fis = ifstream(path, ifstream::binary);
+        if(!fis) {
+          throw runtime_error("Failed to open CSV file.");
+        }
+        if(offset > 0) fis.seekg(std::streamoff(offset));
+        if(!fis) {
+          throw runtime_error("Failed to seek in CSV file.");
+        }
+        offset_ = offset;
+        using clock = chrono::steady_clock;
+        const auto adaptive = is_adaptive_read_buffer_size();
+        auto& buffer = read_buffer_; // Chunk buffer reused for all files, the whole size is used for data.
+        while(fis.good() && (n_rows_ < row_range_end_)) {
+          if(buffer.size() < read_buffer_size_) buffer.resize(read_buffer_size_);
+          const auto t0 = adaptive ? clock::now() : clock::time_point();
+          fis.read(buffer.data(), std::streamsize(read_buffer_size_));
+          const auto n_read = size_t(fis.gcount());
+          if(n_read == 0) continue;
+          const auto t1 = adaptive ? clock::now() : clock::time_point();
+          stats_.on_chunk(n_read);
+          push(string_view_type(buffer.data(), n_read));
+          if(adaptive && (n_read == read_buffer_size_)) {
+            const auto read_time = t1 - t0;
+            const auto parse_time = clock::now() - t1;
+            if(read_time > parse_time) {
+              read_buffer_size_ = std::min(read_buffer_size_ * 2, read_buffer_size_max_);
+            } else if((read_time * 4) < parse_time) {
+              read_buffer_size_ = std::max(aligned_read_buffer_size(read_buffer_size_ / 2), read_buffer_size_min_);
+            }
+          }
+        }
+        finish();
+        if((!fis.eof()) && (n_rows_ < row_range_end_)) throw runtime_error("Not all CSV file data could be read.");
+      }
+
+      /**
+       * Resumable parse state at the end of a chunk.
+       */
+      enum class parse_state : uint8_t {
+        line_start,     // Start of a line (header comments are detected here).
+        field_start,    // Start of a field (quotes are registered here).
+        unquoted,       // In unquoted field data (or after the closing quote).
+        quoted,         // In a quoted field.
+        quoted_quote,   // After a quote in a quoted field, escape sequence or closing quote.
+        after_cr,       // After a CR line end, a following LF is skipped.
+        comment,        // In a header comment line.
+        skip_line       // In a row discarded by the limit policy, up to the next line end.
+      };
+
+      /**
+       * Internal partial CSV parsing (@see `feed()`). The end of
+       * the data is determined by the length only, a `'\0'` in the
+       * data is a normal field character.
+       * @param const string_view_type csv_text
+       * @return basic_parser&
+       */
+      basic_parser& push(const string_view_type csv_text)
+      {
+        using namespace std;
+        if(csv_text.empty()) return *this;
+        auto cursor = static_cast<const char_type*>(csv_text.data());
+        const auto end = cursor + csv_text.size();
+
+        const auto peek = [&](){
+          return (cursor != end) ? (*cursor) : char_type(0);
+        };
+
+        const auto skip = [&](){
+          ++cursor;
+          return peek();
+        };
+
+        auto selected = is_selected_column(col_);
+        auto skip_from = static_cast<const char_type*>(nullptr); // Position where a row limit was exceeded.
+
+        const auto exceed_limit = [&](const char* message, const char_type* position){
+          if(limits_.policy == limit_policy::error) throw std::runtime_error(message);
+          skip_from = position;
+        };
+
+        // View mode: The current field data in the chunk, if they are not copied to `current_field_`.
+        [[maybe_unused]] auto field_first = static_cast<const char_type*>(nullptr);
+        [[maybe_unused]] auto field_last = static_cast<const char_type*>(nullptr);
+
+        const auto field_view = [&](){
+          // The current field data, buffered or (view mode) referred to in the chunk.
+          if constexpr(is_view_parser) {
+            if(current_field_.empty()) return string_view_type(field_first, size_t(field_last - field_first));
+          }
+          return string_view_type(current_field_);
+        };
+
+        // View mode: Without trim characters and size limits, the field data are referred
+        // to directly, there is no trim or limit bookkeeping needed.
+        [[maybe_unused]] const auto direct_views = !dialect_.has_trim_chars() && !streaming_field_
+          && (limits_.max_field_size == std::numeric_limits<size_t>::max()) && (limits_.max_row_size == std::numeric_limits<size_t>::max());
+
+        const auto append_view = [&](const char_type* first, const char_type* last){
+          // Contiguous field data are referred to in the chunk, fields composed of
+          // multiple pieces (escaped quotes, data after the closing quote) are copied.
+          if(!current_field_.empty()) {
+            current_field_.append(first, last);
+          } else if(field_first == field_last) {
+            field_first = first;
+            field_last = last;
+          } else if(field_last == first) {
+            field_last = last;
+          } else if(first != last) {
+            current_field_.assign(field_first, field_last);
+            current_field_.append(first, last);
+            field_first = field_last = nullptr;
+          }
+        };
+
+        const auto clear_field = [&](){
+          if constexpr(is_view_parser) {
+            if(!current_field_.empty()) current_field_.clear(); // No buffer write (aliasing the members) for fields in the chunk.
+            field_first = field_last = nullptr;
+          } else {
+            current_field_.clear();
+          }
+        };
+
+        const auto skip_row = [&](){
+          // Discards the row, the line is skipped from the position where the limit was
+          // exceeded (independent of the chunk boundaries) to the next line end.
+          cursor = skip_from;
+          skip_from = nullptr;
+          current_line_.clear();
+          clear_field();
+          if constexpr(is_view_parser) { escaped_.clear(); escaped_fields_.clear(); owned_fields_ = 0; }
+          col_ = 0;
+          row_size_ = 0;
+          skipped_chars_ = false;
+          selected = is_selected_column(col_);
+          ++n_skipped_rows_;
+          return parse_state::skip_line;
+        };
+
+        const auto append_field = [&](const char_type* first, const char_type* last){
+          if constexpr(is_view_parser) {
+            if(direct_views && selected) { append_view(first, last); return; }
+          }
+          if(!selected) { skipped_chars_ = skipped_chars_ || (first != last); return; }
+          if(streaming_field_) {
+            // The field has content, but is not buffered (no leading trim characters any more).
+            oversize_field_handler_(string_view_type(first, size_t(last - first)), n_rows_, col_, false);
+            return;
+          }
+          if(dialect_.has_trim_chars() && field_view().empty()) {
+            // Leading trim characters are skipped instead of copied (the field is not an empty line).
+            const auto b = first;
+            while((first != last) && dialect_.is_trim_char(*first)) ++first;
+            skipped_chars_ = skipped_chars_ || (first != b);
+          }
+          // The buffered data never exceed the limits, so the remaining space is not negative.
+          const auto space = std::min(limits_.max_field_size, limits_.max_row_size - row_size_) - field_view().size();
+          if(size_t(last - first) > space) {
+            const auto size = field_view().size() + size_t(last - first);
+            if((size > limits_.max_field_size) && oversize_field_handler_) {
+              // The buffered part, these data, and the rest of the field are streamed out.
+              if(!field_view().empty()) oversize_field_handler_(field_view(), n_rows_, col_, false);
+              oversize_field_handler_(string_view_type(first, size_t(last - first)), n_rows_, col_, false);
+              clear_field();
+              skipped_chars_ = true;
+              streaming_field_ = true;
+            } else {
+              exceed_limit((size > limits_.max_field_size) ? "CSV field size limit exceeded." : "CSV row size limit exceeded.", first + space);
+            }
+            return;
+          }
+          if constexpr(is_view_parser) {
+            append_view(first, last);
+          } else if constexpr(stats_type::enabled) {
+            const auto capacity = current_field_.capacity();
+            current_field_.append(first, last);
+            if(current_field_.capacity() != capacity) stats_.on_field_allocation();
+          } else {
+            current_field_.append(first, last);
+          }
+        };
+
+        const auto consume = [&](){
+          append_field(cursor, cursor+1);
+          return skip();
+        };
+
+        const auto consume_until = [&](const auto& needles){
+          // Bulk-append the characters up to the next structural character.
+          const auto pos = find_first_of(cursor, end, needles);
+          append_field(cursor, pos);
+          cursor = pos;
+          return peek();
+        };
+
+        const auto is_comment_char = [&](const char_type c){
+          // Leading lines (before the first row) starting with one of the comment chars are ignored.
+          return dialect_.has_comment_chars() && (n_rows_ == 0) && dialect_.is_comment_char(c);
+        };
+
+        const auto trim_field = [&](string& s) -> void {
+          // Leading trim characters are already skipped in `append_field()`,
+          // hence, only the end is trimmed (without moving the field data).
+          if((!dialect_.has_trim_chars()) || s.empty()) return;
+          auto epos = s.size();
+          while((epos > 0) && dialect_.is_trim_char(s[epos-1])) --epos;
+          s.resize(epos);
+        };
+
+        const auto finish_field = [&](){
+          if constexpr(is_view_parser) {
+            if(direct_views && selected && current_field_.empty()) {
+              const auto size = size_t(field_last - field_first);
+              current_line_.emplace_back(field_first, size);
+              row_size_ += size;
+              stats_.on_field(size);
+              field_first = field_last = nullptr;
+              skipped_chars_ = false;
+              return;
+            }
+          }
+          if(selected) {
+            if(streaming_field_) {
+              oversize_field_handler_(string_view_type(), n_rows_, col_, true);
+              streaming_field_ = false;
+            }
+            if constexpr(is_view_parser) {
+              auto size = current_field_.size();
+              if(size == 0) {
+                while(dialect_.has_trim_chars() && (field_last != field_first) && dialect_.is_trim_char(*(field_last-1))) --field_last;
+                size = size_t(field_last - field_first);
+                current_line_.emplace_back(field_first, size);
+              } else {
+                // Copied fields are stored in the line buffer, the views are set when the line is finished.
+                trim_field(current_field_);
+                size = current_field_.size();
+                escaped_fields_.push_back({size_t(current_line_.size()), escaped_.size(), size});
+                escaped_.append(current_field_);
+                current_line_.emplace_back();
+              }
+              row_size_ += size;
+              stats_.on_field(size);
+              clear_field();
+            } else {
+              trim_field(current_field_);
+              row_size_ += current_field_.size();
+              stats_.on_field(current_field_.size());
+              current_line_.emplace_back();
+              current_field_.swap(current_line_.back());
+            }
+          }
+          skipped_chars_ = false;
+        };
+
+        const auto finish_line = [&](const size_t row_size){
+          if((col_ == 0) && field_view().empty() && !skipped_chars_) return false;
+          finish_field();
+          if constexpr(is_view_parser) {
+            for(const auto& e: escaped_fields_) current_line_[e.index] = string_view_type(escaped_.data() + e.offset, e.size);
+          }
+          stats_.on_row(col_+1, row_size);
+          if(row_index_ != nullptr) {
+            if((n_rows_ % row_index_->rows_per_entry()) == 0) row_index_->push_back({n_rows_, row_offset_, row_line_no_});
+          } else if(scan_ != nullptr) {
+            scan_row();
+          } else if(is_header_row()) {
+            read_header();
+          } else if((n_rows_ >= row_range_first_) && (n_rows_ < row_range_end_)) {
+            row_handler_(current_line_, line_no_);
+          }
+          current_line_.clear();
+          if constexpr(is_view_parser) {
+            if(!escaped_fields_.empty()) { escaped_.clear(); escaped_fields_.clear(); }
+            owned_fields_ = 0;
+          }
+          col_ = 0;
+          row_size_ = 0;
+          ++n_rows_;
+          selected = is_selected_column(col_);
+          return true;
+        };
+
+        const auto next_column = [&](){
+          if(++col_ >= limits_.max_fields) exceed_limit("CSV row field count limit exceeded.", cursor);
+          selected = is_selected_column(col_);
+        };
+
+        // The parse state is resumed from the previous chunk, and stored
+        // for the next one when the end of this chunk is reached.
+        auto state = state_;
+
+        const auto is_fast_path_state = [&](const parse_state st){
+          return (st != parse_state::quoted) && (st != parse_state::quoted_quote) && (st != parse_state::comment)
+            && (st != parse_state::skip_line) && !(dialect_.has_comment_chars() && (n_rows_ == 0));
+        };
+
+        // Unquoted fast path: Outside of quoted fields and header comments, only the
+        // delimiter and the line ends are structural characters. Fields starting with
+        // a quote are left to the state machine below, which resumes the fast path
+        // after the field.
+        while(cursor != end) {
+          if(is_fast_path_state(state)) {
+            const auto needles = array<char_type, 3>{dialect_.delimiter(), '\r', '\n'};
+            while(cursor != end) {
+              if(state == parse_state::after_cr) {
+                if(*cursor == '\n') ++cursor; // CRLF
+                state = parse_state::line_start;
+                continue;
+              }
+              if((state == parse_state::line_start) || (state == parse_state::field_start)) {
+                if(dialect_.quoting() && (*cursor == '"')) break;
+                if(state == parse_state::line_start) {
+                  row_offset_ = offset_ + size_t(cursor - csv_text.data());
+                  row_line_no_ = line_no_;
+                }
+              }
+              const auto pos = find_first_of(cursor, end, needles);
+              if constexpr(is_view_parser) {
+                if(direct_views && selected && (state != parse_state::unquoted)) {
+                  field_first = cursor;
+                  field_last = pos;
+                } else {
+                  append_field(cursor, pos);
+                }
+              } else {
+                append_field(cursor, pos);
+              }
+              if(skip_from != nullptr) { state = skip_row(); break; }
+              state = (pos == cursor) ? ((state == parse_state::line_start) ? parse_state::field_start : state) : parse_state::unquoted;
+              cursor = pos;
+              if(cursor == end) break;
+              const auto c = *cursor;
+              if(c == dialect_.delimiter()) {
+                ++cursor;
+                finish_field();
+                next_column();
+                state = parse_state::field_start;
+                if(skip_from != nullptr) { state = skip_row(); break; }
+              } else {
+                const auto row_size = stats_type::enabled ? (offset_ + size_t(cursor - csv_text.data()) - row_offset_) : size_t(0);
+                ++cursor;
+                ++line_no_;
+                finish_line(row_size);
+                state = (c == '\r') ? parse_state::after_cr : parse_state::line_start;
+              }
+            }
+          }
+          while(cursor != end) {
+            auto c = peek();
+            switch(state) {
+              case parse_state::after_cr:
+                if(c == '\n') skip(); // CRLF
+                state = parse_state::line_start;
+                continue;
+              case parse_state::comment:
+                cursor = find_first_of(cursor, end, array<char_type, 2>{'\r', '\n'});
+                if(cursor == end) continue;
+                c = peek();
+                skip();
+                ++line_no_;
+                state = (c == '\r') ? parse_state::after_cr : parse_state::line_start;
+                continue;
+              case parse_state::skip_line:
+                cursor = find_first_of(cursor, end, array<char_type, 2>{'\r', '\n'});
+                if(cursor == end) continue;
+                c = peek();
+                skip();
+                ++line_no_;
+                state = (c == '\r') ? parse_state::after_cr : parse_state::line_start;
+                continue;
+              case parse_state::quoted:
+                c = consume_until(array<char_type, 1>{'"'});
+                if(skip_from != nullptr) { state = skip_row(); continue; }
+                if(cursor == end) continue;
+                skip();
+                state = parse_state::quoted_quote;
+                continue;
+              case parse_state::quoted_quote:
+                if(c == '"') {
+                  consume(); // RFC4180 double-quote escape, the second quote is part of the field.
+                  state = (skip_from != nullptr) ? skip_row() : parse_state::quoted;
+                } else {
+                  state = parse_state::unquoted; // Closing quote, characters up to the delimiter are appended.
+                  if((scan_ != nullptr) && !(dialect_.char_class(c) & (cc_delimiter|cc_newline|cc_trim)) && (row_error_ == scan_error::none)) row_error_ = scan_error::data_after_quote;
+                }
+                continue;
+              case parse_state::unquoted:
+                // RFC4180: Quotes are only registered directly after the delimiter or the start
+                // of line, so any quotes in the field are accepted as normal character.
+                c = consume_until(array<char_type, 3>{dialect_.delimiter(), '\r', '\n'});
+                if(skip_from != nullptr) { state = skip_row(); continue; }
+                if(cursor == end) continue;
+                break;
+              case parse_state::line_start:
+                if(is_comment_char(c)) {
+                  skip();
+                  state = parse_state::comment;
+                  continue;
+                }
+                row_offset_ = offset_ + size_t(cursor - csv_text.data());
+                row_line_no_ = line_no_;
+                state = parse_state::field_start;
+                [[fallthrough]];
+              case parse_state::field_start:
+              default:
+                if(dialect_.char_class(c) & cc_quote) {
+                  stats_.on_quoted_field();
+                  skip();
+                  state = parse_state::quoted;
+                  continue;
+                }
+                break;
+            }
+            // Field start or end of unquoted field data, dispatched by byte class.
+            const auto cls = dialect_.char_class(c);
+            if(cls & cc_delimiter) {
+              skip();
+              finish_field();
+              next_column();
+              state = (skip_from != nullptr) ? skip_row() : parse_state::field_start;
+            } else if(cls & cc_newline) {
+              const auto row_size = stats_type::enabled ? (offset_ + size_t(cursor - csv_text.data()) - row_offset_) : size_t(0);
+              skip(); // RFC4180 specifies \r\n, but we accept CR, LF, or CRLF as newline.
+              ++line_no_;
+              finish_line(row_size);
+              state = (c == '\r') ? parse_state::after_cr : parse_state::line_start;
+            } else {
+              state = parse_state::unquoted;
+            }
+            if(is_fast_path_state(state)) break;
+          }
+        }
+        if((state != parse_state::line_start) && (state != parse_state::after_cr) && (state != parse_state::comment) && (state != parse_state::skip_line)) stats_.on_split_row();
+        if constexpr(is_view_parser) {
+          // The unfinished row is continued in the next chunk, its views into this chunk are copied.
+          for(auto i = owned_fields_; i < size_t(current_line_.size()); ++i) {
+            const auto field = current_line_[i];
+            if(field.empty()) { current_line_[i] = string_view_type(); continue; } // Empty or copied field.
+            escaped_fields_.push_back({i, escaped_.size(), field.size()});
+            escaped_.append(field.data(), field.size());
+          }
+          owned_fields_ = size_t(current_line_.size());
+          if(field_first != field_last) current_field_.assign(field_first, field_last);
+          field_first = field_last = nullptr;
+        }
+        state_ = state;
+        offset_ += csv_text.size();
+        return *this;
+      }
+
+      /**
+       * Pipelined parsing of the data read from the input
+       * source `SourceType` (@see `parse_file_pipelined()`).
+       * @tparam typename SourceType
+       * @param const std::filesystem::path& path
+       * @param const size_t num_buffers
+       */
+      template<typename SourceType>
+      void parse_pipelined(const std::filesystem::path& path, const size_t num_buffers)
+      {
+        clear();
+        auto reader = basic_pipelined_file_reader<string_type, SourceType>(path, read_buffer_size_, num_buffers);
+        auto chunk = string_type();
+        while(reader.acquire(chunk)) {
+          stats_.on_chunk(chunk.size());
+          push(string_view_type(chunk.data(), chunk.size()));
+          reader.release(std::move(chunk));
+        }
+        finish();
+      }
+
+      /**
+       * Range pre-scanning states (RFC4180 state machine with
+       * the line start distinguished from the field start, and
+       * CRLF counted as one newline), and character classes.
+       */
+      enum range_state : uint8_t { rs_row_start, rs_row_start_cr, rs_field_start, rs_unquoted, rs_quoted, rs_quoted_quote, rs_num_states };
+      enum range_char_class : uint8_t { rc_other, rc_quote, rc_delimiter, rc_cr, rc_lf, rc_num_classes };
+
+      using range_table_type = std::array<std::array<uint8_t, rc_num_classes>, rs_num_states>;
+      using range_class_table_type = std::array<uint8_t, 256>;
+
+      static constexpr range_table_type range_transitions = {{
+        // other        quote            delimiter       cr               lf
+        {{rs_unquoted,  rs_quoted,       rs_field_start, rs_row_start_cr, rs_row_start}}, // rs_row_start
+        {{rs_unquoted,  rs_quoted,       rs_field_start, rs_row_start_cr, rs_row_start}}, // rs_row_start_cr
+        {{rs_unquoted,  rs_quoted,       rs_field_start, rs_row_start_cr, rs_row_start}}, // rs_field_start
+        {{rs_unquoted,  rs_unquoted,     rs_field_start, rs_row_start_cr, rs_row_start}}, // rs_unquoted
+        {{rs_quoted,    rs_quoted_quote, rs_quoted,      rs_quoted,       rs_quoted   }}, // rs_quoted
+        {{rs_unquoted,  rs_quoted,       rs_field_start, rs_row_start_cr, rs_row_start}}, // rs_quoted_quote
+      }};
+
+      static constexpr range_table_type range_line_increments = {{
+        {{0, 0, 0, 1, 1}}, // rs_row_start
+        {{0, 0, 0, 1, 0}}, // rs_row_start_cr (LF of CRLF)
+        {{0, 0, 0, 1, 1}}, // rs_field_start
+        {{0, 0, 0, 1, 1}}, // rs_unquoted
+        {{0, 0, 0, 0, 0}}, // rs_quoted
+        {{0, 0, 0, 1, 1}}, // rs_quoted_quote
+      }};
+
+      /**
+       * Range pre-scanning result: End state and number of lines
+       * (newlines outside quotes) for each start state.
+       */
+      struct range_scan_type
+      {
+        std::array<uint8_t, rs_num_states> end_state;
+        std::array<size_t, rs_num_states> n_lines;
+      };
+
+      /**
+       * Returns the range pre-scanning character classes of the
+       * dialect (quotes are normal characters without quoting).
+       * @return range_class_table_type
+       */
+      range_class_table_type range_char_classes() const noexcept
+      {
+        auto classes = range_class_table_type();
+        if(dialect_.quoting()) classes[uint8_t('"')] = rc_quote;
+        classes[uint8_t('\r')] = rc_cr;
+        classes[uint8_t('\n')] = rc_lf;
+        classes[uint8_t(dialect_.delimiter())] = rc_delimiter;
+        return classes;
+      }
+
+      /**
+       * Runs the range state machine over `[p, end)`, with
+       * vectorized skipping of quoted and unquoted field data.
+       * @param const char_type* p
+       * @param const char_type* const end
+       * @param uint8_t& state
+       * @param size_t& n_lines
+       * @param const range_class_table_type& classes
+       */
+      void scan_range(const char_type* p, const char_type* const end, uint8_t& state, size_t& n_lines, const range_class_table_type& classes) const noexcept
+      {
+        while(p != end) {
+          if(state == rs_quoted) {
+            p = find_first_of(p, end, std::array<char_type, 1>{'"'});
+          } else if(state == rs_unquoted) {
+            p = find_first_of(p, end, std::array<char_type, 3>{dialect_.delimiter(), '\r', '\n'});
+          }
+          if(p == end) break;
+          const auto c = classes[uint8_t(*p++)];
+          n_lines += range_line_increments[state][c];
+          state = range_transitions[state][c];
+        }
+      }
+
+      /**
+       * Speculative range pre-scan for all start states. The
+       * hypotheses are scanned separately for a short prefix,
+       * after that, each distinct state is scanned only once.
+       * @param const char_type* const begin
+       * @param const char_type* const end
+       * @param const range_class_table_type& classes
+       * @return range_scan_type
+       */
+      range_scan_type scan_range(const char_type* const begin, const char_type* const end, const range_class_table_type& classes) const noexcept
+      {
+        constexpr auto prefix_size = size_t(4096);
+        const auto prefix_end = begin + std::min(size_t(end - begin), prefix_size);
+        auto prefix = range_scan_type();
+        auto result = range_scan_type();
+        for(uint8_t s = 0; s < rs_num_states; ++s) {
+          prefix.end_state[s] = s;
+          prefix.n_lines[s] = 0;
+          scan_range(begin, prefix_end, prefix.end_state[s], prefix.n_lines[s], classes);
+        }
+        for(uint8_t s = 0; s < rs_num_states; ++s) {
+          auto t = uint8_t(0);
+          while((t < s) && (prefix.end_state[t] != prefix.end_state[s])) ++t;
+          if(t < s) {
+            // Same state after the prefix, same continuation.
+            result.end_state[s] = result.end_state[t];
+            result.n_lines[s] = prefix.n_lines[s] + (result.n_lines[t] - prefix.n_lines[t]);
+          } else {
+            result.end_state[s] = prefix.end_state[s];
+            result.n_lines[s] = prefix.n_lines[s];
+            scan_range(prefix_end, end, result.end_state[s], result.n_lines[s], classes);
+          }
+        }
+        return result;
+      }
+
+      /**
+       * Returns the position after the line end of the row
+       * continued at `p` in the range state `state`, or `end`
+       * if the data end before.
+       * @param const char_type* p
+       * @param const char_type* const end
+       * @param uint8_t state
+       * @param const range_class_table_type& classes
+       * @return const char_type*
+       */
+      static const char_type* find_range_row_end(const char_type* p, const char_type* const end, uint8_t state, const range_class_table_type& classes) noexcept
+      {
+        while(p != end) {
+          const auto c = classes[uint8_t(*p++)];
+          if(range_line_increments[state][c] != 0) return p;
+          state = range_transitions[state][c];
+        }
+        return end;
+      }
+
+      /**
+       * Returns true if the field of the column with the
+       * zero-based index `col` is passed to the row handler.
+       * @param const size_t col
+       * @return bool
+       */
+      bool is_selected_column(const size_t col) const noexcept
+      { return selected_columns_.empty() || ((col < selected_columns_.size()) && selected_columns_[col]) || is_header_row(); }
+
+      /**
+       * Returns true while the header row is parsed (all
+       * fields are stored, independent of the projection),
+       * if there is a header map or a selection by name.
+       * @return bool
+       */
+      bool is_header_row() const noexcept
+      { return ((header_ != nullptr) || !selected_column_names_.empty()) && (n_rows_ == 0); }
+
+      /**
+       * Validation scan of the input read or parsed by `fn()`, with
+       * all fields skipped (@see `scan_file()`).
+       * @tparam typename Function
+       * @param const Function& fn
+       * @param const size_t max_malformed_rows
+       * @return scan_result
+       */
+      template<typename Function>
+      scan_result scan_input(const Function& fn, const size_t max_malformed_rows)
+      {
+        auto result = scan_result();
+        auto selected = std::vector<char>(1, 0); // No column selected, all fields are skipped.
+        selected_columns_.swap(selected);
+        scan_ = &result;
+        max_malformed_rows_ = max_malformed_rows;
+        try {
+          fn();
+        } catch(...) {
+          scan_ = nullptr;
+          selected_columns_.swap(selected);
+          throw;
+        }
+        scan_ = nullptr;
+        selected_columns_.swap(selected);
+        result.num_bytes = offset_;
+        result.num_lines = line_no_;
+        return result;
+      }
+
+      /**
+       * Registers the finished row in the validation scan result.
+       */
+      void scan_row()
+      {
+        auto& result = *scan_;
+        const auto num_cols = col_ + 1;
+        if(result.num_rows == 0) {
+          result.min_columns = result.max_columns = num_cols;
+        } else {
+          result.min_columns = std::min(result.min_columns, num_cols);
+          result.max_columns = std::max(result.max_columns, num_cols);
+          if((row_error_ == scan_error::none) && (num_cols != first_row_columns_)) row_error_ = scan_error::column_count;
+        }
+        if(result.num_rows == 0) first_row_columns_ = num_cols;
+        ++result.num_rows;
+        if(row_error_ == scan_error::none) return;
+        if(result.malformed_rows.size() < max_malformed_rows_) result.malformed_rows.push_back({n_rows_, row_offset_, row_line_no_, row_error_});
+        ++result.num_malformed_rows;
+        row_error_ = scan_error::none;
+      }
+
+      /**
+       * Resolves the column names selected for the projection, and
+       * stores the names of the projected columns of the current line
+       * (the header row) in the header map, if set.
+       * @throws std::runtime_error
+       */
+      void read_header()
+      {
+        if(!selected_column_names_.empty()) {
+          auto selected = std::vector<char>();
+          for(const auto& name:selected_column_names_) {
+            const auto it = std::find(current_line_.begin(), current_line_.end(), name);
+            if(it == current_line_.end()) throw std::runtime_error("CSV column name not found in header.");
+            const auto i = size_t(std::distance(current_line_.begin(), it));
+            if(i >= selected.size()) selected.resize(i+1, 0);
+            selected[i] = 1;
+          }
+          selected_columns_.swap(selected);
+        }
+        if(header_ == nullptr) return;
+        auto names = std::vector<string_view_type>();
+        for(size_t i = 0; i < size_t(current_line_.size()); ++i) {
+          if(selected_columns_.empty() || ((i < selected_columns_.size()) && selected_columns_[i])) names.emplace_back(current_line_[i]);
+        }
+        header_->assign(names);
+      }
+
+      /**
+       * Returns `size` rounded up to a multiple of `read_buffer_alignment`
+       * (at least one), so that file chunks read from the start end
+       * at file page boundaries (the buffer address is not aligned).
+       * @param const size_t size
+       * @return size_t
+       */
+      static constexpr size_t aligned_read_buffer_size(const size_t size) noexcept
+      { return std::max(size_t(1), (size + read_buffer_alignment - 1) / read_buffer_alignment) * read_buffer_alignment; }
+
+    private:
+
+      struct escaped_field_type { size_t index, offset, size; };
+
+      const row_handler_type row_handler_;          // Function invoked for each CSV row.
+      const dialect_type dialect_;                  // Delimiter, quoting, header comment and trim characters.
+      std::vector<char> selected_columns_;          // Column projection flags by column index, empty for all columns.
+      std::vector<string_type> selected_column_names_; // Column projection by name, resolved in the header row.
+      header_map* header_;                          // Header row column names, null if there is no header row.
+      row_limits limits_;                           // Memory limits and policy for single rows.
+      oversize_field_handler_type oversize_field_handler_; // Streaming of fields exceeding the size limit, empty for none.
+
+      string_container_type current_line_;          // Internal state: Fields registered so far for the current CSV line.
+      string_type current_field_;                   // Internal state: Currently unfinished field characters.
+      string_type escaped_;                         // Internal state (view mode): Copied fields of the current line (escaped, or continued in the next chunk).
+      std::vector<escaped_field_type> escaped_fields_; // Internal state (view mode): Fields of the current line located in `escaped_`.
+      size_t owned_fields_;                         // Internal state (view mode): Number of leading fields of the current line not referring to a chunk.
+      size_t col_;                                  // Internal state: Column index of the current field.
+      size_t row_size_;                             // Internal state: Buffered bytes of the finished fields in the current row.
+      bool skipped_chars_;                          // Internal state: The skipped current field has characters (not an empty line).
+      bool streaming_field_;                        // Internal state: The current field is streamed to the oversize field handler.
+      parse_state state_;                           // Internal state: Parse state at the end of the last chunk.
+      size_t line_no_;                              // Internal state: Current line number in the CSV file.
+      size_t n_rows_;                               // Internal state: Number of data rows parser so far.
+      size_t offset_;                               // Internal state: Byte offset of the current chunk in the input.
+      size_t row_offset_;                           // Internal state: Byte offset of the current row start.
+      size_t row_line_no_;                          // Internal state: Number of lines before the current row.
+      size_t row_range_first_;                      // Row range: First data row passed to the row handler.
+      size_t row_range_end_;                        // Row range: End of the data rows passed to the row handler (and read).
+      row_index* row_index_;                        // Row index being built, null when parsing.
+      scan_result* scan_;                           // Validation scan result, null when parsing.
+      size_t max_malformed_rows_;                   // Validation scan: Number of malformed rows recorded.
+      size_t first_row_columns_;                    // Validation scan: Number of fields of the first data row.
+      scan_error row_error_;                        // Validation scan: Error found in the current row.
+      size_t n_skipped_rows_;                       // Limit policy: Number of discarded rows.
+      size_t read_buffer_size_;                     // File reading chunk size (adapted between the min and max).
+      size_t read_buffer_size_min_;                 // Minimum adaptive file reading chunk size.
+      size_t read_buffer_size_max_;                 // Maximum adaptive file reading chunk size.
+      string_type read_buffer_;                     // File reading chunk buffer, allocated once and reused.
+      stats_type stats_;                            // Statistics: Policy object with optional counters.
+    };
+
+    /**
+     * CSV view parser class template (@see `basic_parser`, view mode):
+     * The row handler gets views, which refer directly to the input data
+     * unless the fields are escaped or the row is continued in the next
+     * chunk.
+     */
+    template<
+      size_t ReadBufferSizeKb,      // File reading chunk size.
+      typename StringType,          // String type used for internal buffers, @concept: must be std::string like.
+      typename ViewContainerType,   // Container<StringView> type used, @concept: must be random access and basic_string_view<char> as value_type.
+      typename RowHandlerType = std::function<void(const ViewContainerType& fields, size_t line_no)> // Row handler type, @concept: const-invocable with `(const ViewContainerType&, size_t)`.
+    >
+    using basic_view_parser = basic_parser<ReadBufferSizeKb, StringType, ViewContainerType, RowHandlerType>;
+
+    /**
+     * Converts a field into a typed value: Arithmetic types
+     * via `std::from_chars()` directly from the field data
+     * (the whole field must be consumed), `std::string_view`
+     * and `std::string` as they are. Returns `std::errc()`
+     * on success, otherwise the conversion error; the value
+     * is not modified on error.
+     * @tparam typename ValueType
+     * @param const std::string_view field
+     * @param ValueType& value
+     * @return std::errc
+     */
+    template<typename ValueType>
+    inline std::errc from_field(const std::string_view field, ValueType& value)
+    {
+      if constexpr(std::is_same<ValueType, std::string_view>::value) {
+        value = field;
+        return std::errc();
+      } else if constexpr(std::is_same<ValueType, std::string>::value) {
+        value.assign(field.data(), field.size());
+        return std::errc();
+      } else {
+        static_assert(std::is_arithmetic<ValueType>::value && !std::is_same<ValueType, bool>::value, "Typed CSV columns must be integral, floating point, std::string_view or std::string.");
+        const auto end = field.data() + field.size(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        auto parsed = ValueType();
+        const auto result = std::from_chars(field.data(), end, parsed);
+        if(result.ec != std::errc()) return result.ec;
+        if(result.ptr != end) return std::errc::invalid_argument;
+        value = parsed;
+        return std::errc();
+      }
+    }
+
+    /**
+     * Row handler adapter, which converts the field views of
+     * a row into a `std::tuple<ColumnTypes...>` (field `i` into
+     * tuple element `i`, further fields are ignored), and invokes
+     * the typed row handler with the tuple, the conversion errors
+     * of the cells (`std::errc()` for valid cells, `invalid_argument`
+     * also for missing fields), and the line number.
+     */
+    template<
+      typename TypedRowHandlerType, // Typed row handler, @concept: const-invocable with `(const std::tuple<ColumnTypes...>&, const std::array<std::errc, N>&, size_t)`.
+      typename... ColumnTypes       // Column value types.
+    >
+    class basic_typed_row_converter
+    {
+    public:
+
+      using row_type = std::tuple<ColumnTypes...>;
+      using errors_type = std::array<std::errc, sizeof...(ColumnTypes)>;
+      using typed_row_handler_type = TypedRowHandlerType;
+
+    public:
+
+      basic_typed_row_converter() = delete;
+      basic_typed_row_converter(const basic_typed_row_converter&) = default;
+      basic_typed_row_converter(basic_typed_row_converter&&) noexcept = default;
+      basic_typed_row_converter& operator=(const basic_typed_row_converter&) = default;
+      basic_typed_row_converter& operator=(basic_typed_row_converter&&) noexcept = default;
+      ~basic_typed_row_converter() noexcept = default;
+
+      /**
+       * Implicit construction from the typed row handler, so
+       * that the parser can be constructed with it directly.
+       * @param FunctionType&& on_row
+       */
+      template<typename FunctionType, typename = std::enable_if_t<!std::is_same<std::decay_t<FunctionType>, basic_typed_row_converter>::value>>
+      basic_typed_row_converter(FunctionType&& on_row) // NOLINT(google-explicit-constructor)
+      : typed_row_handler_(std::forward<FunctionType>(on_row))
+      {}
+
+    public:
+
+      /**
+       * Row handler function (@see `basic_parser`, view mode).
+       * @tparam typename ViewContainerType
+       * @param const ViewContainerType& fields
+       * @param const size_t line_no
+       */
+      template<typename ViewContainerType>
+      void operator()(const ViewContainerType& fields, const size_t line_no) const
+      {
+        auto row = row_type();
+        auto errors = errors_type();
+        convert(fields, row, errors, std::index_sequence_for<ColumnTypes...>());
+        typed_row_handler_(static_cast<const row_type&>(row), static_cast<const errors_type&>(errors), line_no);
+      }
+
+    private:
+
+      template<typename ViewContainerType, size_t... I>
+      static void convert(const ViewContainerType& fields, row_type& row, errors_type& errors, std::index_sequence<I...>)
+      {
+        ((errors[I] = (I < fields.size()) ? from_field(std::string_view(fields[I]), std::get<I>(row)) : std::errc::invalid_argument), ...);
+      }
+
+    private:
+
+      const typed_row_handler_type typed_row_handler_;  // Function invoked for each converted row.
+    };
+
+    /**
+     * Parallel multi-file parsing: Parses a list of CSV files on a
+     * work-stealing thread pool with one reused parser (read buffer
+     * and row container) per thread. Files smaller than `pack_size()`
+     * are packed into one task per thread queue, files larger than
+     * `split_size()` are split into row ranges using a row index
+     * (@see `basic_parser::build_row_index()`), which is built by one
+     * thread while the others continue with other files. Larger tasks
+     * are scheduled first, idle threads steal tasks from the fronts
+     * of the other queues.
+     *
+     * The index pass reads a split file once more, but it is quote-aware
+     * without copying fields, and the range tasks then use the normal
+     * seeking `parse_file()` overload: They work with unmapped files,
+     * get exact line numbers, and are scheduled like any other task.
+     * The pre-scan of `parse_file_parallel()` would need the mapped
+     * file and one thread per range at the same time instead.
+     */
+    template<
+      typename ParserType   // Parser type, @concept: `basic_parser` with run-time dialect.
+    >
+    class basic_file_scheduler
+    {
+    public:
+
+      using parser_type = ParserType;
+      using char_type = typename parser_type::char_type;
+      using string_view_type = typename parser_type::string_view_type;
+      using string_container_type = typename parser_type::string_container_type;
+      using row_handler_type = std::function<void(size_t file_index, const string_container_type& fields, size_t line_no)>;
+      using handler_factory_type = std::function<row_handler_type(size_t thread_index)>;
+      using completion_handler_type = std::function<void(size_t file_index, size_t num_rows, std::exception_ptr error)>;
+
+    public:
+
+      basic_file_scheduler(const basic_file_scheduler&) = default;
+      basic_file_scheduler(basic_file_scheduler&&) noexcept = default;
+      basic_file_scheduler& operator=(const basic_file_scheduler&) = default;
+      basic_file_scheduler& operator=(basic_file_scheduler&&) noexcept = default;
+      ~basic_file_scheduler() noexcept = default;
+
+      /**
+       * File scheduler constructor, the arguments are passed
+       * to the parsers (@see `basic_parser`).
+       *
+       * @param [csv_delimiter] The CSV separator character.
+       * @param [header_comment_characters] Leading lines starting with one of the characters in the string will be ignored.
+       * @param [trim_characters] Characters to be trimmed off at the start and end of each field.
+       */
+      explicit basic_file_scheduler(
+        const char_type csv_delimiter = ',',
+        const string_view_type header_comment_characters = string_view_type(""),
+        const string_view_type trim_characters = string_view_type("")
+      ) : delimiter_(csv_delimiter), header_comment_chars_(header_comment_characters), trim_chars_(trim_characters),
+          num_threads_(0), pack_size_(size_t(1) << 20), split_size_(size_t(64) << 20)
+      {}
+
+    public:
+
+      /**
+       * Sets the number of threads, 0 = hardware concurrency (default).
+       * @param const size_t n
+       * @return basic_file_scheduler&
+       */
+      basic_file_scheduler& num_threads(const size_t n) noexcept
+      { num_threads_ = n; return *this; }
+
+      /**
+       * Sets the size in bytes up to which files are packed
+       * into one task (default 1MB).
+       * @param const size_t bytes
+       * @return basic_file_scheduler&
+       */
+      basic_file_scheduler& pack_size(const size_t bytes) noexcept
+      { pack_size_ = bytes; return *this; }
+
+      /**
+       * Sets the size in bytes of the row ranges, into which larger
+       * files are split (default 64MB), 0 disables splitting.
+       * @param const size_t bytes
+       * @return basic_file_scheduler&
+       */
+      basic_file_scheduler& split_size(const size_t bytes) noexcept
+      { split_size_ = bytes; return *this; }
+
+      /**
+       * Parses the files `paths`. The `handler_factory` is invoked
+       * once per thread (in the calling thread before parsing), the
+       * returned row handlers are only invoked in their thread, with
+       * the index of the file in `paths`. Rows of a file are passed
+       * in order, except for split files, where the row ranges may be
+       * processed concurrently by different threads (each range in
+       * order). `on_done` is invoked (in the thread which finished the
+       * last task of a file) with the number of rows passed to the
+       * row handlers and the exception if parsing failed. Without
+       * `on_done`, the first parse error is rethrown after all files
+       * have been processed.
+       *
+       * @param const std::vector<std::filesystem::path>& paths
+       * @param const handler_factory_type& handler_factory
+       * @param const completion_handler_type& on_done
+       * @throw std::exception
+       */
+      void parse_files(const std::vector<std::filesystem::path>& paths, const handler_factory_type& handler_factory, const completion_handler_type& on_done = completion_handler_type())
+      {
+        using namespace std;
+        if(paths.empty()) return;
+
+        // File states and initial tasks, largest first.
+        auto files = vector<file_state>(paths.size());
+        auto order = vector<size_t>(paths.size());
+        auto total_size = size_t(0);
+        for(size_t i = 0; i < paths.size(); ++i) {
+          order[i] = i;
+          auto ec = error_code();
+          const auto size = filesystem::file_size(paths[i], ec);
+          files[i].size = ec ? size_t(0) : size_t(size);
+          total_size += files[i].size;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return files[a].size > files[b].size; });
+        const auto max_tasks = ((split_size_ > 0) && (files[order.front()].size > split_size_)) ? std::numeric_limits<size_t>::max() : (paths.size() + total_size / std::max(pack_size_, size_t(1)));
+        const auto n = std::max(size_t(1), std::min((num_threads_ > 0) ? num_threads_ : size_t(thread::hardware_concurrency()), max_tasks));
+        auto queues = vector<task_queue>(n);
+        auto num_tasks = atomic<size_t>(0);   // Queued and running tasks, the workers return at 0.
+        auto num_queued = atomic<size_t>(0);  // Queued tasks, idle workers wait until there are any.
+        {
+          auto next = size_t(0);
+          auto pack = vector<size_t>();
+          auto pack_bytes = size_t(0);
+          const auto add = [&](task_type&& task){ queues[next++ % n].tasks.push_back(std::move(task)); ++num_tasks; ++num_queued; };
+          for(const auto i: order) {
+            files[i].pending = 1;
+            if((split_size_ > 0) && (files[i].size > split_size_)) {
+              add(task_type{task_kind::split, {i}, 0, 0, nullptr});
+            } else if(files[i].size >= pack_size_) {
+              add(task_type{task_kind::files, {i}, 0, 0, nullptr});
+            } else {
+              pack.push_back(i);
+              pack_bytes += files[i].size;
+              if(pack_bytes >= pack_size_) { add(task_type{task_kind::files, std::move(pack), 0, 0, nullptr}); pack.clear(); pack_bytes = 0; }
+            }
+          }
+          if(!pack.empty()) add(task_type{task_kind::files, std::move(pack), 0, 0, nullptr});
+        }
+
+        // One parser per thread, the row handler adapter passes the current file index.
+        auto current_file = vector<size_t>(n);
+        auto num_rows = vector<size_t>(n);
+        auto parsers = vector<parser_type>();
+        parsers.reserve(n);
+        for(size_t t = 0; t < n; ++t) {
+          auto handler = handler_factory(t);
+          auto* file = &current_file[t];
+          auto* rows = &num_rows[t];
+          parsers.emplace_back([handler=std::move(handler), file, rows](const string_container_type& fields, size_t line_no){
+            handler(*file, fields, line_no); ++*rows;
+          }, delimiter_, header_comment_chars_, trim_chars_);
+        }
+
+        auto wait_mtx = mutex();
+        auto wait_cv = condition_variable();
+        auto first_error = exception_ptr();
+        auto error_mtx = mutex();
+
+        const auto file_done = [&](const size_t i){
+          auto& file = files[i];
+          if(--file.pending != 0) return;
+          if(on_done) {
+            try { on_done(i, file.rows.load(), file.error); } catch(...) { const auto lck = lock_guard<mutex>(error_mtx); if(!first_error) first_error = current_exception(); }
+          } else if(file.error) {
+            const auto lck = lock_guard<mutex>(error_mtx);
+            if(!first_error) first_error = file.error;
+          }
+        };
+
+        const auto fail = [&](const size_t i, exception_ptr e){
+          auto& file = files[i];
+          const auto lck = lock_guard<mutex>(error_mtx);
+          if(!file.error) file.error = e;
+          file.failed = true;
+        };
+
+        const auto pop = [&](const size_t t, task_type& task){
+          for(size_t k = 0; k < n; ++k) {
+            auto& queue = queues[(t + k) % n];
+            const auto lck = lock_guard<mutex>(queue.mtx);
+            if(queue.tasks.empty()) continue;
+            task = std::move(queue.tasks.front()); // Own queue first, then stealing, the largest task first.
+            queue.tasks.pop_front();
+            --num_queued;
+            return true;
+          }
+          return false;
+        };
+
+        const auto run_task = [&](const size_t t, task_type& task){
+          auto& parser = parsers[t];
+          switch(task.kind) {
+            case task_kind::files:
+              for(const auto i: task.files) {
+                current_file[t] = i;
+                num_rows[t] = 0;
+                try { parser.parse_file(paths[i]); } catch(...) { fail(i, current_exception()); }
+                files[i].rows += num_rows[t];
+                file_done(i);
+              }
+              break;
+            case task_kind::split: {
+              const auto i = task.files.front();
+              try {
+                const auto index = make_shared<const row_index>(parser.build_row_index(paths[i]));
+                const auto rows_per_range = std::max(size_t(1), (index->num_rows() * split_size_ / std::max(files[i].size, size_t(1)) + index->rows_per_entry() - 1) / index->rows_per_entry()) * index->rows_per_entry();
+                auto queued = false;
+                {
+                  // Counted before a thief can pop (and uncount) one of the tasks.
+                  auto& queue = queues[t];
+                  const auto lck = lock_guard<mutex>(queue.mtx);
+                  for(size_t first = 0; first < index->num_rows(); first += rows_per_range) {
+                    ++files[i].pending;
+                    ++num_tasks;
+                    ++num_queued;
+                    queue.tasks.push_back(task_type{task_kind::range, {i}, first, rows_per_range, index});
+                    queued = true;
+                  }
+                }
+                if(queued) {
+                  { const auto lck = lock_guard<mutex>(wait_mtx); } // No lost wake-up between the predicate check and the wait.
+                  wait_cv.notify_all();
+                }
+              } catch(...) {
+                fail(i, current_exception());
+              }
+              file_done(i);
+              break;
+            }
+            case task_kind::range: {
+              const auto i = task.files.front();
+              current_file[t] = i;
+              num_rows[t] = 0;
+              if(!files[i].failed) {
+                try { parser.parse_file(paths[i], *task.index, task.first_row, task.num_rows); } catch(...) { fail(i, current_exception()); }
+              }
+              files[i].rows += num_rows[t];
+              file_done(i);
+              break;
+            }
+          }
+        };
+
+        const auto worker = [&](const size_t t){
+          auto task = task_type();
+          for(;;) {
+            if(pop(t, task)) {
+              run_task(t, task);
+              task = task_type();
+              if(--num_tasks == 0) {
+                { const auto lck = lock_guard<mutex>(wait_mtx); }
+                wait_cv.notify_all();
+              }
+              continue;
+            }
+            auto lck = unique_lock<mutex>(wait_mtx);
+            wait_cv.wait(lck, [&](){ return (num_queued != 0) || (num_tasks == 0); });
+            if(num_tasks == 0) return;
+          }
+        };
+
+        auto threads = vector<thread>();
+        threads.reserve(n - 1);
+        try {
+          for(size_t t = 1; t < n; ++t) threads.emplace_back(worker, t);
+        } catch(...) {
+          // Fewer threads: The remaining tasks are processed by the started threads.
+        }
+        worker(0);
+        for(auto& th: threads) th.join();
+        if(first_error) rethrow_exception(first_error);
+      }
+
+    private:
+
+      enum class task_kind : uint8_t { files, split, range };
+
+      struct task_type
+      {
+        task_kind kind = task_kind::files;
+        std::vector<size_t> files;                   // Files parsed completely (in order), or the split file.
+        size_t first_row = 0;                        // Row range of a split file.
+        size_t num_rows = 0;
+        std::shared_ptr<const row_index> index;      // Row index of a split file.
+      };
+
+      struct task_queue
+      {
+        std::mutex mtx;
+        std::deque<task_type> tasks;                 // Tasks in descending size order, split file ranges are appended.
+      };
+
+      struct file_state
+      {
+        size_t size = 0;                             // File size in bytes.
+        std::atomic<size_t> pending{0};              // Unfinished tasks of the file.
+        std::atomic<size_t> rows{0};                 // Rows passed to the row handlers.
+        std::atomic<bool> failed{false};             // A task of the file failed, remaining ranges are skipped.
+        std::exception_ptr error;                    // First error of the file.
+      };
+
+    private:
+
+      char_type delimiter_;                          // Parser setting: The CSV separator character.
+      std::basic_string<char_type> header_comment_chars_; // Parser setting: Header comment characters.
+      std::basic_string<char_type> trim_chars_;      // Parser setting: Trim characters.
+      size_t num_threads_;                           // Number of threads, 0 = hardware concurrency.
+      size_t pack_size_;                             // Files smaller than this are packed into one task.
+      size_t split_size_;                            // Files larger than this are split into row ranges of this size, 0 = no splitting.
+    };
+  }
+
+  /**
+   * CSV parser default specialization.
+   */
+  using csv_parser = detail::basic_parser<1024, std::string, std::vector<std::string>>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * CSV view parser default specialization.
+   */
+  using csv_view_parser = detail::basic_view_parser<1024, std::string, std::vector<std::string_view>>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * Row offset index for random row access (@see `csv_parser::build_row_index()`).
+   */
+  using csv_row_index = detail::row_index;
+
+  /**
+   * Validation scan result and malformed row reasons (@see `csv_parser::scan_file()`).
+   */
+  using csv_scan_result = detail::scan_result;
+  using csv_scan_error = detail::scan_error;
+
+  /**
+   * Parser memory limits for single rows and the limit policy (@see `csv_parser::limits()`).
+   */
+  using csv_row_limits = detail::row_limits;
+  using csv_limit_policy = detail::limit_policy;
+
+  /**
+   * Parallel multi-file parser with `csv_parser` threads.
+   */
+  using csv_file_scheduler = detail::basic_file_scheduler<csv_parser>;
+
+  /**
+   * Header row column name to field index map (@see `csv_parser::header_row()`).
+   */
+  using csv_header = detail::header_map;
+
+  /**
+   * Parser statistics counters (@see `csv_instrumented_parser::stats()`).
+   */
+  using csv_parser_stats = detail::parser_stats;
 
+  /**
+   * CSV parser specialization counting bytes, chunks, rows,
+   * fields, quoted fields, maximum field/row sizes and buffer
+   * growths in `stats()`.
+   */
+  using csv_instrumented_parser = detail::basic_parser<1024, std::string, std::vector<std::string>, std::function<void(const std::vector<std::string>& fields, size_t line_no)>, detail::dynamic_dialect, csv_parser_stats>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * Field pool default specialization.
+   */
+  using csv_field_pool = detail::basic_field_pool<std::string>;
+
+  /**
+   * CSV parser specialization with recycled field strings,
+   * allocation free in the steady state. The row handler
+   * gets a `const csv_field_pool&` instead of a vector.
+   */
+  using csv_pooled_parser = detail::basic_parser<1024, std::string, csv_field_pool>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * CSV parser default specialization with the row handler type as
+   * template argument instead of `std::function`, so that the handler
+   * can be inlined into the parsing loop:
+   * `csv::csv_inline_parser<decltype(on_row)>(on_row)`.
+   */
+  template<typename RowHandlerType>
+  using csv_inline_parser = detail::basic_parser<1024, std::string, std::vector<std::string>, RowHandlerType>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * Compile-time character set of a `csv_dialect`, e.g. `csv_chars<' ', '\t'>`.
+   */
+  template<char... Chars>
+  using csv_chars = detail::char_set<Chars...>;
+
+  /**
+   * Compile-time CSV dialect: Delimiter, quoting on/off, header
+   * comment and trim characters, e.g.
+   * `csv::csv_dialect<';', true, csv::csv_chars<'#'>, csv::csv_chars<' ', '\t'>>`.
+   */
+  template<char Delimiter, bool Quoting = true, typename CommentCharSet = csv_chars<>, typename TrimCharSet = csv_chars<>>
+  using csv_dialect = detail::static_dialect<Delimiter, Quoting, CommentCharSet, TrimCharSet>;
+
+  /**
+   * CSV parser default specialization with a compile-time dialect,
+   * constructed only with the row handler:
+   * `csv::csv_dialect_parser<csv::csv_dialect<';'>>(on_row)`.
+   * The row handler type can be given for inlining as well.
+   */
+  template<typename DialectType, typename RowHandlerType = std::function<void(const std::vector<std::string>& fields, size_t line_no)>>
+  using csv_dialect_parser = detail::basic_parser<1024, std::string, std::vector<std::string>, RowHandlerType, DialectType>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * CSV view parser default specialization with the row handler
+   * type as template argument (@see `csv_inline_parser`).
+   */
+  template<typename RowHandlerType>
+  using csv_inline_view_parser = detail::basic_view_parser<1024, std::string, std::vector<std::string_view>, RowHandlerType>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+  /**
+   * Typed row handler default type of `csv_typed_parser`.
+   */
+  template<typename... ColumnTypes>
+  using csv_typed_row_handler = std::function<void(const std::tuple<ColumnTypes...>& row, const std::array<std::errc, sizeof...(ColumnTypes)>& errors, size_t line_no)>;
+
+  /**
+   * CSV view parser specialization, which converts the fields
+   * directly from the input data into typed values (@see
+   * `detail::from_field()`): `csv::csv_typed_parser<int64_t, double,
+   * std::string_view>(on_row)`, with `on_row(row_tuple, errors, line_no)`.
+   */
+  template<typename... ColumnTypes>
+  using csv_typed_parser = detail::basic_view_parser<1024, std::string, std::vector<std::string_view>, detail::basic_typed_row_converter<csv_typed_row_handler<ColumnTypes...>, ColumnTypes...>>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+
+}}
 
 /**
- * CSV parsing.
+ * CSV row batching.
  */
 namespace csv { namespace {
 
   namespace detail {
 
     /**
-     * CSV parser class template, tune your performance
-     * vs memory consumption via `ReadBufferSizeKb`, which
-     * has a notable performance impact due to stream
-     * reading.
+     * Batch of CSV rows in contiguous memory: The field data
+     * of all rows are stored in one character buffer, fields
+     * and rows are referred to by offset arrays. Clearing the
+     * batch keeps the allocated capacity for the next rows.
      */
     template<
-      size_t ReadBufferSizeKb,      // File reading chunk size.
-      typename StringType,          // String type used, @concept: must be std::string like.
-      typename StringContainerType  // Container<String> type used, @concept: must be ramdom access and StringType as value_type.
+      typename StringType           // String type used for the character buffer, @concept: must be std::string like.
     >
-    class basic_parser
+    class basic_row_batch
     {
     public:
 
       using string_type = StringType;
       using char_type = typename string_type::value_type;
       using string_view_type = std::basic_string_view<char_type>;
-      using string_container_type = StringContainerType;
-      using row_handler_type = std::function<void(const string_container_type& fields, size_t line_no)>;
+      using offsets_type = std::vector<size_t>;
 
-      static constexpr size_t read_buffer_size_kb = ReadBufferSizeKb;
+    public:
+
+      basic_row_batch() : data_(), field_offsets_(1, 0), row_offsets_(1, 0), line_numbers_() {}
+      basic_row_batch(const basic_row_batch&) = default;
+      basic_row_batch(basic_row_batch&&) noexcept = default;
+      basic_row_batch& operator=(const basic_row_batch&) = default;
+      basic_row_batch& operator=(basic_row_batch&&) noexcept = default;
+      ~basic_row_batch() noexcept = default;
 
     public:
 
-      basic_parser() = delete;
-      basic_parser(const basic_parser&) = delete;
-      basic_parser(basic_parser&&) noexcept = default;
-      basic_parser& operator=(const basic_parser&) = delete;
-      basic_parser& operator=(basic_parser&&) noexcept = default;
-      ~basic_parser() noexcept = default;
+      /**
+       * Returns the number of rows in the batch.
+       * @return size_t
+       */
+      size_t size() const noexcept
+      { return line_numbers_.size(); }
 
       /**
-       * CSV parser constructor (the only allowed one).
-       *
-       * @param on_row Function invoked for each CSV row.
-       * @param [csv_delimiter] The CSV separator character.
-       * @param [header_comment_characters] Leading lines starting with one of the characters in the string will be ignored.
-       * @param [trim_characters] Characters to be trimmed off at the start and end of each field (CSV entry). Whitespaces are often trimmed.
+       * Returns true if the batch contains no rows.
+       * @return bool
        */
-      explicit basic_parser(
-        const row_handler_type on_row,
-        const char_type csv_delimiter = ',',
-        const string_view_type header_comment_characters = string_view_type(""),
-        const string_view_type trim_characters = string_view_type("")
-      )
-      : row_handler_(on_row),
-        delimiter_(csv_delimiter),
-        header_comment_chars_(header_comment_characters),
-        trim_chars_(trim_characters),
-        current_line_(),
-        current_field_(),
-        line_no_(),
-        n_rows_()
+      bool empty() const noexcept
+      { return line_numbers_.empty(); }
+
+      /**
+       * Returns the number of fields of a row.
+       * @param const size_t row
+       * @return size_t
+       */
+      size_t num_fields(const size_t row) const noexcept
+      { return row_offsets_[row + 1] - row_offsets_[row]; }
+
+      /**
+       * Returns a view of a field of a row, valid until
+       * the batch is cleared or modified.
+       * @param const size_t row
+       * @param const size_t col
+       * @return string_view_type
+       */
+      string_view_type field(const size_t row, const size_t col) const noexcept
       {
-        // Support for < c++20: Explicit checks, no use of concepts yet:
-        static_assert(std::is_same<string_type, typename string_container_type::value_type>::value, "StringContainerType has to have StringType as elements.");
-        static_assert(std::is_default_constructible<string_container_type>::value, "StringContainerType must be a default-constructible dynamic sized container.");
-        // Also: wstring not needed by anyone, string with custom allocator maybe:
-        static_assert(std::is_same<char, char_type>::value, "wstring not supported. Widen/narrow in your code.");
+        const auto i = row_offsets_[row] + col;
+        return string_view_type(data_.data() + field_offsets_[i], field_offsets_[i + 1] - field_offsets_[i]);
+      }
+
+      /**
+       * Returns the CSV line number of a row.
+       * @param const size_t row
+       * @return size_t
+       */
+      size_t line_no(const size_t row) const noexcept
+      { return line_numbers_[row]; }
+
+      /**
+       * Returns the number of field data characters
+       * in the batch.
+       * @return size_t
+       */
+      size_t data_size() const noexcept
+      { return data_.size(); }
+
+      /**
+       * Returns the character buffer with the data of
+       * all fields (without separators).
+       * @return const string_type&
+       */
+      const string_type& data() const noexcept
+      { return data_; }
+
+      /**
+       * Returns the field offsets in `data()`, field `i`
+       * spans `[field_offsets()[i], field_offsets()[i+1])`.
+       * @return const offsets_type&
+       */
+      const offsets_type& field_offsets() const noexcept
+      { return field_offsets_; }
+
+      /**
+       * Returns the row offsets in `field_offsets()`, the
+       * fields of row `r` are `[row_offsets()[r], row_offsets()[r+1])`.
+       * @return const offsets_type&
+       */
+      const offsets_type& row_offsets() const noexcept
+      { return row_offsets_; }
+
+    public:
+
+      /**
+       * Removes all rows, the allocated memory is kept.
+       * @return basic_row_batch&
+       */
+      basic_row_batch& clear() noexcept
+      {
+        data_.clear();
+        field_offsets_.resize(1);
+        row_offsets_.resize(1);
+        line_numbers_.clear();
+        return *this;
+      }
+
+      /**
+       * Appends a row.
+       * @tparam typename FieldContainer: @concept forward-iterable, string-like elements.
+       * @param const FieldContainer& fields
+       * @param const size_t line_no
+       * @return basic_row_batch&
+       */
+      template<typename FieldContainer>
+      basic_row_batch& push_back(const FieldContainer& fields, const size_t line_no)
+      {
+        for(const auto& field: fields) {
+          const auto s = string_view_type(field);
+          data_.append(s.data(), s.size());
+          field_offsets_.push_back(data_.size());
+        }
+        row_offsets_.push_back(field_offsets_.size() - 1);
+        line_numbers_.push_back(line_no);
+        return *this;
       }
 
-    public:
+    private:
+
+      string_type data_;            // Field data of all rows.
+      offsets_type field_offsets_;  // Start offsets of the fields in `data_`, with the end offset as last element.
+      offsets_type row_offsets_;    // Start indices of the rows in `field_offsets_`, with the end index as last element.
+      offsets_type line_numbers_;   // CSV line numbers of the rows.
+    };
+
+    /**
+     * Columnar batch of CSV rows (struct of arrays, Arrow-like
+     * layout): The fields of each column are stored in a separate
+     * contiguous character buffer with an offset array, field `r`
+     * of column `c` spans `[column_offsets(c)[r], column_offsets(c)[r+1])`
+     * of `column_data(c)`. Columns are added by the first row with
+     * more fields, missing fields of shorter rows are empty. Clearing
+     * the batch keeps the allocated column buffers for the next rows.
+     */
+    template<
+      typename StringType           // String type used for the column character buffers, @concept: must be std::string like.
+    >
+    class basic_column_batch
+    {
+    public:
+
+      using string_type = StringType;
+      using char_type = typename string_type::value_type;
+      using string_view_type = std::basic_string_view<char_type>;
+      using offsets_type = std::vector<size_t>;
+
+    public:
+
+      basic_column_batch() : columns_(), num_cols_(), line_numbers_(), data_size_() {}
+      basic_column_batch(const basic_column_batch&) = default;
+      basic_column_batch(basic_column_batch&&) noexcept = default;
+      basic_column_batch& operator=(const basic_column_batch&) = default;
+      basic_column_batch& operator=(basic_column_batch&&) noexcept = default;
+      ~basic_column_batch() noexcept = default;
+
+    public:
+
+      /**
+       * Returns the number of rows in the batch.
+       * @return size_t
+       */
+      size_t size() const noexcept
+      { return line_numbers_.size(); }
+
+      /**
+       * Returns true if the batch contains no rows.
+       * @return bool
+       */
+      bool empty() const noexcept
+      { return line_numbers_.empty(); }
 
       /**
-       * Clears the internal state (but not the
-       * construction settings), so that a new
-       * CSV data set can be processed.
-       * @return basic_parser&
+       * Returns the number of columns in the batch.
+       * @return size_t
        */
-      basic_parser& clear()
+      size_t num_columns() const noexcept
+      { return num_cols_; }
+
+      /**
+       * Returns the number of fields of a row, which is the
+       * number of columns for all rows (as `basic_row_batch`).
+       * @return size_t
+       */
+      size_t num_fields(const size_t) const noexcept
+      { return num_cols_; }
+
+      /**
+       * Returns a view of a field, valid until the batch
+       * is cleared or modified.
+       * @param const size_t row
+       * @param const size_t col
+       * @return string_view_type
+       */
+      string_view_type field(const size_t row, const size_t col) const noexcept
       {
-        current_line_ = string_container_type(),
-        current_field_ = string_type(),
-        line_no_ = 0;
-        n_rows_ = 0;
-        return *this;
+        const auto& c = columns_[col];
+        return string_view_type(c.data.data() + c.offsets[row], c.offsets[row + 1] - c.offsets[row]);
       }
 
       /**
-       * Partial CSV parsing, invokes `row_handler` directly
-       * when a data line is completed. Leaves unfinished line
-       * data in the internal buffer for the next feed cycle.
-       * Use `finish()` to ensure that the last line of file
-       * or stream is not lost.
-       * @param string_type&& csv_text
-       * @return basic_parser&
+       * Returns the character buffer with the field
+       * data of a column (without separators).
+       * @param const size_t col
+       * @return const string_type&
        */
-      basic_parser& feed(string_type&& csv_text)
-      { return push(std::move(csv_text), true); }
+      const string_type& column_data(const size_t col) const noexcept
+      { return columns_[col].data; }
 
       /**
-       * Adds the internally buffered line in case there is no
-       * trailing newline in the CSV data before end of input.
-       * Use `finish()` after all data have been processed using
-       * `feed()`. This method is not automatically invoked in
-       * the destructor, as the (your) `row_handler` may throw.
-       * @return basic_parser&
+       * Returns the field offsets of a column in
+       * `column_data(col)`, with `size()+1` elements.
+       * @param const size_t col
+       * @return const offsets_type&
        */
-      basic_parser& finish()
-      { feed("\n"); return *this; }
+      const offsets_type& column_offsets(const size_t col) const noexcept
+      { return columns_[col].offsets; }
 
       /**
-       * Parses and finishes (@see `feed()` and `finish()`) a
-       * complete CSV text.
-       * @param string_type&& csv_text
+       * Returns the CSV line number of a row.
+       * @param const size_t row
+       * @return size_t
        */
-      void parse(string_type&& csv_text)
-      { clear(); feed(std::move(csv_text)); finish(); }
+      size_t line_no(const size_t row) const noexcept
+      { return line_numbers_[row]; }
 
       /**
-       * Reads and parses a CSV (regular) file given by
-       * its filesystem path. Throws on file reading
-       * or memory errors.
-       *
-       * @param const std::filesystem::path& path
-       * @throw std::exception
+       * Returns the number of field data characters
+       * in the batch (all columns).
+       * @return size_t
        */
-      void parse_file(const std::filesystem::path& path)
+      size_t data_size() const noexcept
+      { return data_size_; }
+
+    public:
+
+      /**
+       * Removes all rows and columns, the allocated
+       * column buffers are kept.
+       * @return basic_column_batch&
+       */
+      basic_column_batch& clear() noexcept
       {
-        using namespace std;
-        clear();
-        auto fis = ifstream(path, ifstream::binary);
-        if(!fis) {
-          throw runtime_error("Failed to open CSV file.");
+        num_cols_ = 0;
+        line_numbers_.clear();
+        data_size_ = 0;
+        return *this;
+      }
+
+      /**
+       * Appends a row, the fields are written directly into
+       * their column buffers.
+       * @tparam typename FieldContainer: @concept forward-iterable, string-like elements.
+       * @param const FieldContainer& fields
+       * @param const size_t line_no
+       * @return basic_column_batch&
+       */
+      template<typename FieldContainer>
+      basic_column_batch& push_back(const FieldContainer& fields, const size_t line_no)
+      {
+        auto col = size_t(0);
+        for(const auto& field: fields) {
+          if(col == num_cols_) add_column();
+          const auto s = string_view_type(field);
+          auto& c = columns_[col++];
+          c.data.append(s.data(), s.size());
+          c.offsets.push_back(c.data.size());
+          data_size_ += s.size();
         }
-        while(fis.good()) {
-          constexpr auto chunk_size = string::size_type(read_buffer_size_kb * 1024);
-          auto csv_text = string(chunk_size, '\0');
-          fis.read(csv_text.data(), std::streamsize(csv_text.size()-1));
-          const auto n_read = string::size_type(fis.gcount());
-          if(n_read <= 0) continue;
-          csv_text.resize(n_read+1);
-          push(std::move(csv_text), false);
+        for(; col < num_cols_; ++col) {
+          auto& c = columns_[col];
+          c.offsets.push_back(c.data.size()); // Missing field: empty.
         }
-        finish();
-        if(!fis.eof()) throw runtime_error("Not all CSV file data could be read.");
+        line_numbers_.push_back(line_no);
+        return *this;
       }
 
-    protected:
+    private:
 
       /**
-       * Internal partial CSV parsing (@see `feed()`), where the
-       * peek-ahead reserve memory can be added before to circumvent
-       * unnecessary performance penalty due to re-allocation.
-       * @param string_type&& csv_text
-       * @param bool with_lookahead
-       * @return basic_parser&
+       * Appends a column, with empty fields for the
+       * rows already in the batch.
        */
-      basic_parser& push(string_type&& csv_text, bool with_lookahead)
+      void add_column()
       {
-        using namespace std;
-        if(csv_text.empty()) return *this;
-        if(with_lookahead) csv_text.push_back('\0');
-        auto cursor = csv_text.begin();
-        const auto end = csv_text.end()-1;
+        if(num_cols_ == columns_.size()) columns_.emplace_back();
+        auto& c = columns_[num_cols_++];
+        c.data.clear();
+        c.offsets.assign(size() + 1, 0);
+      }
 
-        const auto peek = [&](){
-          return *cursor;
-        };
+      struct column_type
+      {
+        string_type data;           // Field data of the column.
+        offsets_type offsets;       // Start offsets of the fields in `data`, with the end offset as last element.
+      };
 
-        const auto skip = [&](){
-          ++cursor;
-          return peek();
-        };
+      std::vector<column_type> columns_;  // Columns, including kept buffers beyond `num_cols_`.
+      size_t num_cols_;                   // Number of columns in the batch.
+      offsets_type line_numbers_;         // CSV line numbers of the rows.
+      size_t data_size_;                  // Number of field data characters in all columns.
+    };
 
-        const auto consume = [&](){
-          current_field_.push_back(*cursor);
-          return skip();
-        };
+    /**
+     * Row handler adapter, which collects parsed rows in a reused
+     * `basic_row_batch` (or `basic_column_batch`), and invokes the
+     * batch handler when the batch contains `max_rows` rows or
+     * `max_bytes` characters. Pass it to a parser using `std::ref()`,
+     * and `flush()` after the parser has finished.
+     */
+    template<
+      typename StringType,          // String type used for the batch character buffer, @concept: must be std::string like.
+      typename BatchType = basic_row_batch<StringType> // Batch type, @concept: `basic_row_batch` or `basic_column_batch` like.
+    >
+    class basic_row_batcher
+    {
+    public:
 
-        const auto consume_quoted = [&](){
-          auto c = peek();
-          for(; c; c = consume()) {
-            if(c != '"') continue;
-            // RFC4180 double-quote escape, consume second quote.
-            c = skip();
-            if(c != '"') break;
-          }
-          return c;
-        };
+      using batch_type = BatchType;
+      using batch_handler_type = std::function<void(const batch_type& batch)>;
 
-        const auto consume_unquoted = [&](){
-          // RFC4180: Quotes are only registered directly after the delimiter or the start
-          // of line, so any quotes in the field are accepted as normal character.
-          auto c = consume();
-          for(; c; c=consume()) {
-            if((c==delimiter_) || (c=='\r') || (c=='\n')) break;
-          }
-          return c;
-        };
+    public:
 
-        const auto purge_comments = [&](){
-          if(header_comment_chars_.empty()) return;
-          // Ignores content, as long as lines are empty or starting with
-          // one of the comment_chars.
-          auto c = peek();
-          while(c) {
-            if((c == '\n') || (c == '\r')) {
-              ++line_no_;
-              c = skip();
-            } else if(header_comment_chars_.find(c) != header_comment_chars_.npos) {
-              while(c && (c != '\n') && (c != '\r')) c = skip(); // skip whole line
-            } else {
-              break;
-            }
-          }
-        };
+      basic_row_batcher() = delete;
+      basic_row_batcher(const basic_row_batcher&) = delete;
+      basic_row_batcher(basic_row_batcher&&) noexcept = default;
+      basic_row_batcher& operator=(const basic_row_batcher&) = delete;
+      basic_row_batcher& operator=(basic_row_batcher&&) noexcept = default;
+      ~basic_row_batcher() noexcept = default;
 
-        const auto trim_field = [&](string& s) -> void {
-          if(trim_chars_.empty() || s.empty()) return;
-          const auto npos = s.npos;
-          auto epos = s.size();
-          auto spos = string::size_type(0);
-          while((epos > 0) && trim_chars_.find(s[epos-1]) != npos) --epos;
-          while((spos < epos) && trim_chars_.find(s[spos]) != npos) ++spos;
-          if((spos == 0) && (epos == s.size())) {
-            return;
-          }
-          if(epos <= spos) {
-            s.clear();
-            return;
-          }
-          s.erase(s.begin(), s.begin()+string::difference_type(spos));
-          s.resize(epos-spos);
-        };
+      /**
+       * Row batcher constructor.
+       *
+       * @param on_batch Function invoked for each completed batch.
+       * @param [max_rows] Number of rows, which completes a batch.
+       * @param [max_bytes] Number of field data characters, which completes a batch.
+       */
+      explicit basic_row_batcher(
+        const batch_handler_type on_batch,
+        const size_t max_rows = 4096,
+        const size_t max_bytes = 1024 * 1024
+      )
+      : batch_handler_(on_batch), max_rows_(std::max(max_rows, size_t(1))), max_bytes_(max_bytes), batch_()
+      {}
 
-        const auto finish_line = [&](){
-          if(current_field_.empty() && current_line_.empty()) return false;
-          trim_field(current_field_);
-          current_line_.emplace_back();
-          current_line_.back().swap(current_field_);
-          row_handler_(current_line_, line_no_);
-          current_line_.clear();
-          ++n_rows_;
-          return true;
-        };
+    public:
 
-        if(n_rows_ == 0) purge_comments();
+      /**
+       * Row handler function, appends the row to the batch,
+       * and invokes the batch handler if the batch is full.
+       * @tparam typename FieldContainer
+       * @param const FieldContainer& fields
+       * @param const size_t line_no
+       */
+      template<typename FieldContainer>
+      void operator()(const FieldContainer& fields, const size_t line_no)
+      {
+        batch_.push_back(fields, line_no);
+        if((batch_.size() >= max_rows_) || (batch_.data_size() >= max_bytes_)) flush();
+      }
 
-        while(cursor != end) {
-          const auto c = peek();
-          if(c == delimiter_) {
-            skip();
-            trim_field(current_field_);
-            current_line_.emplace_back();
-            current_field_.swap(current_line_.back());
-          } else if((c == '\r') || (c == '\n')) {
-            const auto cn = skip(); // RFC4180 specifies \r\n, but we accept CR, LF, or CRLF as newline.
-            if((c == '\r') && (cn == '\n')) skip();
-            ++line_no_;
-            if(!finish_line()) continue;
-          } else if(c == '"') {
-            if((!skip()) || (!consume_quoted())) break;
-          } else if(c) {
-            consume_unquoted();
-          } else {
-            break; // '\0', pushed above -> end of string.
-          }
-        }
+      /**
+       * Invokes the batch handler for the remaining rows,
+       * if any.
+       * @return basic_row_batcher&
+       */
+      basic_row_batcher& flush()
+      {
+        if(batch_.empty()) return *this;
+        batch_handler_(batch_);
+        batch_.clear();
         return *this;
       }
 
     private:
 
-      const row_handler_type row_handler_;          // Function invoked for each CSV row.
-      const char_type delimiter_;                   // The CSV separator character.
-      const string_type header_comment_chars_;      // Leading lines starting with one of the characters in the string will be ignored.
-      const string_type trim_chars_;                // Characters to be trimmed off at the start and end of each field.
-
-      string_container_type current_line_;          // Internal state: Fields registered so far for the current CSV line.
-      string_type current_field_;                   // Internal state: Currently unfinished field characters.
-      size_t line_no_;                              // Internal state: Current line number in the CSV file.
-      size_t n_rows_;                               // Internal state: Number of data rows parser so far.
+      const batch_handler_type batch_handler_;  // Function invoked for each batch.
+      const size_t max_rows_;                   // Number of rows completing a batch.
+      const size_t max_bytes_;                  // Number of field data characters completing a batch.
+      batch_type batch_;                        // Currently collected rows.
     };
 
   }
 
   /**
-   * CSV parser default specialization.
+   * Row batch default specialization.
    */
-  using csv_parser = detail::basic_parser<1024, std::string, std::vector<std::string>>; // NOLINT Default: byte string, 1MB file reading buffer cap.
+  using csv_row_batch = detail::basic_row_batch<std::string>;
+
+  /**
+   * Row batcher default specialization.
+   */
+  using csv_row_batcher = detail::basic_row_batcher<std::string>;
+
+  /**
+   * Columnar batch default specialization.
+   */
+  using csv_column_batch = detail::basic_column_batch<std::string>;
+
+  /**
+   * Columnar batcher default specialization, use with a view
+   * parser to copy the fields directly into the column buffers:
+   * `csv::csv_inline_view_parser<decltype(std::ref(batcher))>(std::ref(batcher))`.
+   */
+  using csv_column_batcher = detail::basic_row_batcher<std::string, csv_column_batch>;
 
 }}
 
@@ -372,17 +3858,19 @@ namespace csv { namespace {
       /**
        * CSV composer constructor.
        *
-       * @param const row_handler_type on_row Invoked for every composed line. Use it to output the line.
+       * @param const row_handler_type on_row Invoked for every composed line (or block of lines). Use it to output the line.
        * @param const char_type [csv_delimiter] The CSV separator character.
        * @param const string_view_type [newline_seq] Character sequence used for line breaks.
+       * @param const size_t [output_block_size] Composed lines are collected until this size is reached, and passed to `on_row` as one block (0: each line separately).
        */
       explicit basic_composer(
         const row_handler_type on_row,
         const char_type csv_delimiter = char_type(','),
-        const string_view_type newline_seq = string_view_type("\r\n")
+        const string_view_type newline_seq = string_view_type("\r\n"),
+        const size_t output_block_size = 0
       ) :
         row_handler_(on_row), delimiter_(csv_delimiter), newline_(newline_seq),
-        quote_cols_(), num_cols_()
+        block_size_(output_block_size), quote_cols_(), num_cols_(), output_()
       {
         static_assert(std::is_same<char, char_type>::value, "wstring not supported. Widen/narrow in your code.");
         static_assert(std::is_same<int, typename quote_cols_type::value_type>::value, "Container for forced-quoted column definitions must have `int` as element type.");
@@ -416,9 +3904,9 @@ namespace csv { namespace {
        */
       static string_type quote(const string_view_type field_text)
       {
-        auto s = string_type("\"");
-        for(const auto c:field_text) { s += c; if(c=='"') s+='"'; }
-        s += '"';
+        auto s = string_type();
+        s.reserve(field_text.size() + size_t(std::count(field_text.begin(), field_text.end(), '"')) + 2);
+        append_quoted(s, field_text);
         return s;
       }
 
@@ -434,14 +3922,44 @@ namespace csv { namespace {
        * @return string_type
        */
       string_type escape(const string_view_type field_text) const
+      {
+        auto s = string_type();
+        append_escaped(s, field_text);
+        return s;
+      }
+
+      /**
+       * Appends the quoted text to `out` (@see `quote()`),
+       * without intermediate string.
+       * @param string_type& out
+       * @param const string_view_type field_text
+       */
+      static void append_quoted(string_type& out, const string_view_type field_text)
+      {
+        out += '"';
+        auto start = size_t(0);
+        for(auto pos = field_text.find('"'); pos != field_text.npos; pos = field_text.find('"', start)) {
+          out.append(field_text.substr(start, pos - start + 1));
+          out += '"'; // RFC4180 double-quote escape.
+          start = pos + 1;
+        }
+        out.append(field_text.substr(start));
+        out += '"';
+      }
+
+      /**
+       * Appends the text to `out`, quoted if needed
+       * (@see `escape()`), without intermediate string.
+       * @param string_type& out
+       * @param const string_view_type field_text
+       */
+      void append_escaped(string_type& out, const string_view_type field_text) const
       {
         if(!field_text.empty()) {
-          if((field_text.front() == ' ') || (field_text.back() == ' ')) return quote(field_text);
-          for(const auto c:field_text) {
-            if((c < ' ') || (c == '"') || (c > '~') || (c == delimiter_)) return quote(field_text);
-          }
+          if((field_text.front() == ' ') || (field_text.back() == ' ')) return append_quoted(out, field_text);
+          if(contains_quote_chars(field_text.data(), field_text.data() + field_text.size(), delimiter_)) return append_quoted(out, field_text); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
         }
-        return string_type(field_text);
+        out.append(field_text);
       }
 
     public:
@@ -449,13 +3967,15 @@ namespace csv { namespace {
       /**
        * Clears the internal state of this composer,
        * so that a new data set (with `define_columns()`)
-       * can be started.
+       * can be started. Collected lines, which are not
+       * flushed yet, are discarded (@see `flush()`).
        * @return basic_composer&
        */
       basic_composer& clear()
       {
         quote_cols_.clear();
         num_cols_ = 0;
+        output_.clear();
         return *this;
       }
 
@@ -513,28 +4033,337 @@ namespace csv { namespace {
       template<typename StringViewContainer>
       basic_composer& feed(const StringViewContainer& fields)
       {
+        // The line is composed in the reused output buffer, which is
+        // only flushed when the block size is reached.
+        append_line(output_, fields);
+        if(output_.size() >= block_size_) flush();
+        return *this;
+      }
+
+      /**
+       * Composes one row of typed values (@see `feed()`): Integral
+       * and floating point values are formatted with `std::to_chars()`
+       * directly into the output buffer (shortest round-trip format),
+       * without escape checks, as numbers never need quoting (unless
+       * the delimiter is a character of numbers, or the column is
+       * forced-quoted). Types convertible to `string_view_type` are
+       * escaped as in `feed()`. The number of values must match the
+       * defined number of columns.
+       * @tparam typename... ValueTypes
+       * @param const ValueTypes&... values
+       * @return basic_composer&
+       * @throws std::runtime_error
+       */
+      template<typename... ValueTypes>
+      basic_composer& feed_values(const ValueTypes&... values)
+      {
+        append_values(output_, values...);
+        if(output_.size() >= block_size_) flush();
+        return *this;
+      }
+
+      /**
+       * Composes one row of typed values given as tuple
+       * (@see `feed_values()`).
+       * @tparam typename... ValueTypes
+       * @param const std::tuple<ValueTypes...>& row
+       * @return basic_composer&
+       * @throws std::runtime_error
+       */
+      template<typename... ValueTypes>
+      basic_composer& feed(const std::tuple<ValueTypes...>& row)
+      { return std::apply([this](const auto&... values) -> basic_composer& { return feed_values(values...); }, row); }
+
+      /**
+       * Composes all rows of a `basic_row_batch` or `basic_column_batch`
+       * (@see `feed()`), e.g. for columnar-to-CSV export. The fields are
+       * passed as views of the batch buffers.
+       * @tparam typename BatchType
+       * @param const BatchType& batch
+       * @return basic_composer&
+       * @throws std::runtime_error
+       */
+      template<typename BatchType>
+      basic_composer& feed_batch(const BatchType& batch)
+      {
+        auto fields = std::vector<string_view_type>();
+        for(size_t row = 0; row < batch.size(); ++row) {
+          fields.clear();
+          for(size_t col = 0; col < batch.num_fields(row); ++col) fields.push_back(batch.field(row, col));
+          feed(fields);
+        }
+        return *this;
+      }
+
+      /**
+       * Composes all rows of a random access container (of
+       * `StringViewContainer`s) on multiple threads (@see
+       * `feed_parallel(num_rows, row_of, ...)`).
+       * @tparam typename RowContainer
+       * @param const RowContainer& rows
+       * @param size_t [num_threads] Number of formatting threads, 0 = hardware concurrency.
+       * @param const size_t [rows_per_block] Number of lines per output block.
+       * @return basic_composer&
+       * @throws std::runtime_error
+       */
+      template<typename RowContainer>
+      basic_composer& feed_parallel(const RowContainer& rows, size_t num_threads = 0, const size_t rows_per_block = 4096)
+      {
+        const auto row_of = [&rows](const size_t i) -> decltype(auto) { return rows[typename RowContainer::size_type(i)]; };
+        return feed_parallel(size_t(rows.size()), row_of, num_threads, rows_per_block);
+      }
+
+      /**
+       * Composes `num_rows` rows on multiple threads: The rows
+       * are formatted in blocks of `rows_per_block` lines by a
+       * pool of `num_threads` threads into recycled block buffers,
+       * and the blocks are passed to the `on_row` function in the
+       * original row order, in the calling thread (also if the
+       * composer was constructed for line-wise output). Previously
+       * collected lines are flushed first. `row_of(i)` returns the
+       * fields (a `StringViewContainer`) of row `i`, it is invoked
+       * concurrently and must be thread-safe. On column count errors
+       * or `row_of`/`on_row` exceptions, the blocks before the
+       * failing one have been passed to `on_row`, and the exception
+       * is rethrown.
+       * @tparam typename RowGenerator
+       * @param const size_t num_rows
+       * @param const RowGenerator& row_of
+       * @param size_t [num_threads] Number of formatting threads, 0 = hardware concurrency.
+       * @param const size_t [rows_per_block] Number of lines per output block.
+       * @return basic_composer&
+       * @throws std::runtime_error
+       */
+      template<typename RowGenerator>
+      basic_composer& feed_parallel(const size_t num_rows, const RowGenerator& row_of, size_t num_threads = 0, const size_t rows_per_block = 4096)
+      {
+        using namespace std;
+        flush();
+        if(rows_per_block == 0) throw runtime_error("CSV parallel composing needs at least one row per block.");
+        const auto n_blocks = (num_rows + rows_per_block - 1) / rows_per_block;
+        const auto format_block = [&](string_type& out, const size_t block){
+          out.clear();
+          const auto end = std::min(num_rows, (block + 1) * rows_per_block);
+          for(auto i = block * rows_per_block; i < end; ++i) append_line(out, row_of(i));
+        };
+        if(num_threads == 0) num_threads = size_t(thread::hardware_concurrency());
+        num_threads = std::min(num_threads, n_blocks);
+        if(num_threads < 2) {
+          for(size_t b = 0; b < n_blocks; ++b) {
+            try {
+              format_block(output_, b);
+            } catch(...) {
+              output_.clear(); // The failing block is not passed to `on_row`.
+              throw;
+            }
+            flush();
+          }
+          return *this;
+        }
+
+        // Block `b` is formatted into slot `b % n_slots`. A slot is reused
+        // after its block was passed to `on_row`, which limits the number of
+        // blocks in flight (and the memory) to `n_slots`.
+        const auto n_slots = 2 * num_threads;
+        auto slots = vector<string_type>(n_slots);
+        auto ready = vector<char>(n_slots, 0);
+        auto next_block = size_t(0);
+        auto n_emitted = size_t(0);
+        auto stop = false;
+        auto error = exception_ptr();
+        auto mtx = mutex();
+        auto block_ready = condition_variable();
+        auto slot_free = condition_variable();
+
+        const auto fail = [&](exception_ptr e){
+          {
+            const auto lock = lock_guard<mutex>(mtx);
+            if(!error) error = e;
+            stop = true;
+          }
+          block_ready.notify_all();
+          slot_free.notify_all();
+        };
+
+        const auto worker = [&](){
+          for(;;) {
+            auto block = size_t(0);
+            {
+              auto lock = unique_lock<mutex>(mtx);
+              slot_free.wait(lock, [&](){ return stop || (next_block >= n_blocks) || (next_block < n_emitted + n_slots); });
+              if(stop || (next_block >= n_blocks)) return;
+              block = next_block++;
+            }
+            try {
+              format_block(slots[block % n_slots], block);
+            } catch(...) {
+              fail(current_exception());
+              return;
+            }
+            {
+              const auto lock = lock_guard<mutex>(mtx);
+              ready[block % n_slots] = 1;
+            }
+            block_ready.notify_all();
+          }
+        };
+
+        auto threads = vector<thread>();
+        threads.reserve(num_threads);
+        try {
+          for(size_t k = 0; k < num_threads; ++k) threads.emplace_back(worker);
+        } catch(...) {
+          fail(current_exception());
+        }
+        for(size_t b = 0; b < n_blocks; ++b) {
+          {
+            auto lock = unique_lock<mutex>(mtx);
+            block_ready.wait(lock, [&](){ return stop || ready[b % n_slots]; });
+            if(stop) break;
+          }
+          try {
+            row_handler_(static_cast<const string_type&>(slots[b % n_slots]));
+          } catch(...) {
+            fail(current_exception());
+            break;
+          }
+          {
+            const auto lock = lock_guard<mutex>(mtx);
+            ready[b % n_slots] = 0;
+            ++n_emitted;
+          }
+          slot_free.notify_all();
+        }
+        for(auto& t: threads) t.join();
+        if(error) rethrow_exception(error);
+        return *this;
+      }
+
+      /**
+       * Passes the collected lines, which did not reach
+       * the output block size yet, to the `on_row` function.
+       * Use it after feeding the last row. This method is
+       * not automatically invoked in the destructor, as the
+       * (your) `on_row` function may throw.
+       * @return basic_composer&
+       */
+      basic_composer& flush()
+      {
+        if(output_.empty()) return *this;
+        row_handler_(static_cast<const string_type&>(output_));
+        output_.clear();
+        return *this;
+      }
+
+    protected:
+
+      /**
+       * Appends the composed line of `fields` to `out` (@see
+       * `feed()`). On column count errors, `out` is restored
+       * and an exception thrown. Does not modify the composer,
+       * so that lines can be composed concurrently.
+       * @tparam typename StringViewContainer: @concept forward-iterable
+       * @param string_type& out
+       * @param const StringViewContainer& fields
+       * @throws std::runtime_error
+       */
+      template<typename StringViewContainer>
+      void append_line(string_type& out, const StringViewContainer& fields) const
+      {
+        const auto line_start = out.size();
         size_t i = 0;
-        auto line = string_type();
         for(const auto& field:fields) {
-          if(i > 0) line += delimiter();
-          if(i >= num_cols_) throw std::runtime_error("CSV row feed exceeds the number of defined columns.");
-          line += (quote_cols_[i]) ? (quote(field)) : (escape(field));
+          if(i >= num_cols_) {
+            out.resize(line_start);
+            throw std::runtime_error("CSV row feed exceeds the number of defined columns.");
+          }
+          if(i > 0) out += delimiter();
+          if(quote_cols_[i]) {
+            append_quoted(out, string_view_type(field));
+          } else {
+            append_escaped(out, string_view_type(field));
+          }
           ++i;
         }
-        if(i != num_cols_) throw std::runtime_error("CSV row feed is missing columns.");
-        line += newline();
-        row_handler_(line);
-        return *this;
+        if(i != num_cols_) {
+          out.resize(line_start);
+          throw std::runtime_error("CSV row feed is missing columns.");
+        }
+        out += newline();
+      }
+
+      /**
+       * Appends the composed line of typed `values` to `out`
+       * (@see `feed_values()`). Column count errors are thrown
+       * before `out` is modified.
+       * @tparam typename... ValueTypes
+       * @param string_type& out
+       * @param const ValueTypes&... values
+       * @throws std::runtime_error
+       */
+      template<typename... ValueTypes>
+      void append_values(string_type& out, const ValueTypes&... values) const
+      {
+        if(sizeof...(ValueTypes) > num_cols_) throw std::runtime_error("CSV row feed exceeds the number of defined columns.");
+        if(sizeof...(ValueTypes) < num_cols_) throw std::runtime_error("CSV row feed is missing columns.");
+        auto i = size_t(0);
+        (append_value(out, values, i++), ...);
+        out += newline();
+      }
+
+      /**
+       * Appends the delimiter (except for the first column) and
+       * the typed value of the column index `i` to `out`.
+       * @tparam typename ValueType
+       * @param string_type& out
+       * @param const ValueType& value
+       * @param const size_t i
+       */
+      template<typename ValueType>
+      void append_value(string_type& out, const ValueType& value, const size_t i) const
+      {
+        if(i > 0) out += delimiter();
+        if constexpr(std::is_convertible<const ValueType&, string_view_type>::value) {
+          if(quote_cols_[i]) {
+            append_quoted(out, string_view_type(value));
+          } else {
+            append_escaped(out, string_view_type(value));
+          }
+        } else {
+          static_assert(std::is_arithmetic<ValueType>::value && !std::is_same<ValueType, bool>::value && !std::is_same<ValueType, char_type>::value, "Typed CSV values must be integral (not bool or char), floating point, or convertible to string views.");
+          constexpr auto max_size = size_t(64); // Sufficient for the shortest round-trip representation of all arithmetic types.
+          if(quote_cols_[i] || is_number_char(delimiter_)) {
+            auto buffer = std::array<char_type, max_size>();
+            const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+            const auto text = string_view_type(buffer.data(), size_t(result.ptr - buffer.data()));
+            if(quote_cols_[i]) append_quoted(out, text); else append_escaped(out, text);
+          } else {
+            const auto pos = out.size();
+            out.resize(pos + max_size);
+            const auto result = std::to_chars(out.data() + pos, out.data() + out.size(), value);
+            out.resize(size_t(result.ptr - out.data()));
+          }
+        }
       }
 
+      /**
+       * Returns true if `c` can be part of a formatted number.
+       * @param const char_type c
+       * @return bool
+       */
+      static constexpr bool is_number_char(const char_type c) noexcept
+      { return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'z')) || (c == '-') || (c == '+') || (c == '.'); }
+
     private:
 
-      const row_handler_type row_handler_;  // Function invoked for each CSV line composed.
+      const row_handler_type row_handler_;  // Function invoked for each CSV line (or block of lines) composed.
       const char_type delimiter_;           // The CSV separator character.
       const string_type newline_;           // The newline sequence
+      const size_t block_size_;             // Output block size, 0 for line-wise output.
 
       quote_cols_type quote_cols_;          // Forced-quoted column definitions (1: must quote, 0: only if needed). Intentionally not bool.
       size_t num_cols_;                     // Expected number of pushed columns.
+      string_type output_;                  // Reused output buffer of the composed lines.
     };
 
   }
@@ -11,7 +11,9 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <chrono>
 
@@ -69,6 +71,18 @@ void test_parse_cmpfile_all(
   }
 }
 
+/**
+ * Returns a row handler appending the escaped and joined
+ * fields of each row to `rows` (one line per row), for
+ * all field container types.
+ */
+auto joined_rows_to(std::string& rows)
+{
+  return [&rows](const auto& fields, size_t line_no) {
+    rows += te::csv_escape_joined_row_fields(std::vector<std::string>(fields.begin(), fields.end()), line_no) + "\n";
+  };
+}
+
 void test_fopen_error()
 {
   test_info("Checking file-open exception ...");
@@ -96,9 +110,716 @@ void test_parse_string_stop_at_nulchar()
   test_expect_eq(fields_crammed, "123456789");
 }
 
+void test_find_first_of()
+{
+  using namespace std;
+  test_info("Checking structural character search `csv::detail::find_first_of()` ...");
+  const auto needles = array<char, 4>{',', '\r', '\n', '\0'};
+  auto num_mismatches = 0;
+  for(int i = 0; i < 2000; ++i) {
+    // Random lengths and match positions, so that the vectorized blocks and the tail loop are covered.
+    auto text = string(sw::utest::random<size_t>(0, 200), 'x');
+    if(!text.empty()) {
+      for(auto n = sw::utest::random<size_t>(0, 3); n; --n) {
+        text[sw::utest::random<size_t>(0, text.size() - 1)] = needles[sw::utest::random<size_t>(0, needles.size() - 1)];
+      }
+    }
+    const auto b = text.data();
+    const auto e = text.data() + text.size();
+    const auto offset = text.empty() ? size_t(0) : sw::utest::random<size_t>(0, text.size());
+    if(csv::detail::find_first_of(b + offset, e, needles) != std::find_first_of(b + offset, e, needles.begin(), needles.end())) ++num_mismatches;
+    if(csv::detail::find_first_of(b + offset, e, array<char, 2>{'\r', '\n'}) != std::find_first_of(b + offset, e, needles.begin() + 1, needles.begin() + 3)) ++num_mismatches;
+    if(csv::detail::find_first_of(b + offset, e, array<char, 1>{','}) != std::find(b + offset, e, ',')) ++num_mismatches;
+  }
+  test_expect_eq(num_mismatches, 0);
+}
+
+void test_inline_row_handler()
+{
+  using namespace std;
+  test_info("Checking parsers with the row handler type as template argument ...");
+  const auto csv_text = string("# comment\na,b,c\n\"d\"\"\",e\r\n\n f , g  \n");
+  auto expected = string();
+  auto parsed = string();
+  auto parsed_views = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  const auto view_row_proc = joined_rows_to(parsed_views);
+  test_expect_noexcept(csv::csv_parser(expected_proc, ',', "#", " ").parse(string(csv_text)));
+  test_expect_noexcept(csv::csv_inline_parser<decltype(row_proc)>(row_proc, ',', "#", " ").parse(string(csv_text)));
+  test_expect_noexcept(csv::csv_inline_view_parser<decltype(view_row_proc)>(view_row_proc, ',', "#", " ").parse(csv_text));
+  test_note("Rows:\n" << expected);
+  test_expect(!expected.empty());
+  test_expect(parsed == expected);
+  test_expect(parsed_views == expected);
+}
+
+void test_pooled_parser()
+{
+  using namespace std;
+  test_info("Checking csv_pooled_parser results and steady state field allocations ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  auto csv_text = string();
+  for(size_t row = 0; row < 200; ++row) {
+    csv_text += te::make_random_csv_row(composer, 6, 64, te::rnd_pool_ascii_with_newline());
+  }
+  auto expected = string();
+  auto parsed = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  using instrumented_pooled_parser = csv::detail::basic_parser<1024, string, csv::csv_field_pool, std::function<void(const csv::csv_field_pool&, size_t)>, csv::detail::dynamic_dialect, csv::csv_parser_stats>;
+  auto parser = csv::csv_instrumented_parser(expected_proc);
+  auto pooled_parser = instrumented_pooled_parser(row_proc);
+  auto parser_allocations = vector<size_t>();
+  auto pooled_allocations = vector<size_t>();
+  for(int i = 0; i < 16; ++i) {
+    expected.clear();
+    parsed.clear();
+    test_expect_noexcept(parser.parse(string(csv_text)));
+    test_expect_noexcept(pooled_parser.parse(string(csv_text)));
+    if(!test_expect_cond(parsed == expected)) break;
+    parser_allocations.push_back(parser.stats().num_field_allocations);
+    pooled_allocations.push_back(pooled_parser.stats().num_field_allocations);
+  }
+  test_note("Field allocations csv_parser: " << parser_allocations.front() << " ... " << parser_allocations.back());
+  test_note("Field allocations csv_pooled_parser: " << pooled_allocations.front() << " ... " << pooled_allocations.back());
+  test_expect(parser_allocations.back() > parser_allocations[parser_allocations.size()-2]);
+  test_expect(pooled_allocations.back() == pooled_allocations[pooled_allocations.size()-2]);
+}
+
+void test_column_projection()
+{
+  using namespace std;
+  test_info("Checking csv_parser column projection against filtered full rows ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  for(int i = 0; i < 30; ++i) {
+    auto csv_text = string("# comment\n\n");
+    const auto num_cols = sw::utest::random<size_t>(1, 10);
+    for(size_t row = 0; row < 50; ++row) {
+      csv_text += te::make_random_csv_row(composer, sw::utest::random<size_t>(1, num_cols), 12, te::rnd_pool_ascii_with_newline() + "  ");
+    }
+    auto columns = vector<size_t>();
+    for(size_t col = 1; col <= num_cols + 1; ++col) {
+      if(sw::utest::random<int>(0, 2) == 0) columns.push_back(col);
+    }
+    if(columns.empty()) columns.push_back(num_cols);
+    auto expected = string();
+    auto parsed = string();
+    const auto expected_proc = [&](const vector<string>& fields, size_t line_no) {
+      auto selected = vector<string>();
+      for(const auto col: columns) {
+        if(col <= fields.size()) selected.push_back(fields[col-1]);
+      }
+      expected += te::csv_escape_joined_row_fields(selected, line_no) + "\n";
+    };
+    const auto row_proc = joined_rows_to(parsed);
+    test_expect_noexcept(csv::csv_parser(expected_proc, ',', "#", " ").parse(string(csv_text)));
+    test_expect_noexcept(csv::csv_parser(row_proc, ',', "#", " ").select_columns(columns).parse(string(csv_text)));
+    if(!test_expect_cond(parsed == expected)) {
+      test_note("CSV text:\n" << csv_text);
+      test_note("Expected:\n" << expected);
+      test_note("Parsed:\n" << parsed);
+      return;
+    }
+  }
+  const auto no_proc = [](const vector<string>&, size_t) {};
+  test_expect_except(csv::csv_parser(no_proc).select_columns(vector<int>{1, 0}));
+}
+
+void test_parse_file_pipelined()
+{
+  using namespace std;
+  test_info("Checking parse_file_pipelined() against parse_file() ...");
+  using parser_type = csv::detail::basic_parser<1, string, vector<string>>; // Small chunks (1kb, rounded up to 4kb)
+  const auto path = te::make_random_csv_file("tcsv-pipelined", 256, 5, ',', "#header\n", 40, te::rnd_pool_ascii_with_newline());
+  auto expected = string();
+  auto parsed = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(parser_type(expected_proc, ',', "#").parse_file(path));
+  for(const auto num_buffers: {size_t(0), size_t(2), size_t(8)}) {
+    parsed.clear();
+    test_expect_noexcept(parser_type(row_proc, ',', "#").parse_file_pipelined(path, num_buffers));
+    test_expect(!parsed.empty());
+    test_expect(parsed == expected);
+  }
+  const auto throwing_proc = [](const vector<string>&, size_t) { throw std::runtime_error("row handler error"); };
+  test_expect_except(parser_type(throwing_proc).parse_file_pipelined(path));
+  test_expect_except(parser_type(row_proc).parse_file_pipelined("./no-such-file-or-directory.csv"));
+  std::filesystem::remove(path);
+}
+
+void test_read_buffer_size()
+{
+  using namespace std;
+  test_info("Checking run-time and adaptive read buffer sizes against parse_file() ...");
+  const auto path = te::make_random_csv_file("tcsv-readbuffer", 512, 6, ',', "#header\n", 60, te::rnd_pool_ascii_with_newline());
+  auto expected = string();
+  auto parsed = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(csv::csv_parser(expected_proc, ',', "#").parse_file(path));
+  auto parser = csv::csv_instrumented_parser(row_proc, ',', "#");
+  test_expect_eq(parser.read_buffer_size(), 1024u*1024u);
+  test_expect(!parser.is_adaptive_read_buffer_size());
+  parser.read_buffer_size(5000);
+  test_expect_eq(parser.read_buffer_size(), 8192u); // Rounded up to the page size.
+  test_expect_noexcept(parser.parse_file(path));
+  test_expect(parsed == expected);
+  test_expect_eq(parser.stats().max_chunk_size, 8192u);
+  test_expect_noexcept(parser.parse_file_pipelined(path));
+  parser.adaptive_read_buffer_size(4096, 65536);
+  test_expect(parser.is_adaptive_read_buffer_size());
+  for(size_t i = 0; i < 3; ++i) {
+    parsed.clear();
+    parser.stats().clear();
+    test_expect_noexcept(parser.parse_file(path));
+    test_expect(parsed == expected);
+    test_expect(parser.read_buffer_size() >= 4096u);
+    test_expect(parser.read_buffer_size() <= 65536u);
+    test_expect((parser.read_buffer_size() % 4096u) == 0u);
+    test_expect(parser.stats().max_chunk_size <= 65536u);
+  }
+  test_note("Adapted read buffer size: " << parser.read_buffer_size());
+  test_expect_except(parser.read_buffer_size(0));
+  test_expect_except(parser.adaptive_read_buffer_size(8192, 4096));
+  std::filesystem::remove(path);
+}
+
+void test_header_row()
+{
+  using namespace std;
+  test_info("Checking header_row() name to index map, named rows and projection by name ...");
+  auto header = csv::csv_header();
+  auto rows = vector<string>();
+  const auto row_proc = [&](const vector<string>& fields, size_t line_no) {
+    const auto row = header.row(fields);
+    rows.push_back(to_string(line_no) + ":" + row["price"] + "/" + row[header.column("id")] + "/" + (row.contains("name") ? row.field("name") : string("-")));
+  };
+  auto parser = csv::csv_parser(row_proc, ',', "#", " ");
+  parser.header_row(&header);
+  test_expect_noexcept(parser.parse("# comment\n\n id ,\"name\",price\n1,a,10\n\n2,\"b,c\",20\n"));
+  test_expect(header.names() == (vector<string>{"id", "name", "price"}));
+  test_expect_eq(header.index_of("price"), 2u);
+  test_expect_eq(header.index_of("none"), csv::csv_header::npos);
+  test_expect(rows == (vector<string>{"4:10/1/a", "6:20/2/b,c"}));
+  test_expect_except(parser.parse("id,name,price\n3\n")); // No field for "price".
+  // Projection by name, resolved in the header of each file (different column order).
+  rows.clear();
+  test_expect_noexcept(parser.select_columns(vector<string>{"price", "id"}));
+  test_expect_noexcept(parser.parse("id,name,price\n1,a,10\n2,b,20\n"));
+  test_expect(header.names() == (vector<string>{"id", "price"}));
+  test_expect_noexcept(parser.parse("price,id,name\n30,3,c\n"));
+  test_expect(header.names() == (vector<string>{"price", "id"}));
+  test_expect(rows == (vector<string>{"2:10/1/-", "3:20/2/-", "2:30/3/-"}));
+  test_expect_except(parser.parse("id,name\n1,a\n"));
+  // Selection by name before header_row(), and without header map.
+  auto other = csv::csv_header();
+  rows.clear();
+  test_expect_noexcept(csv::csv_parser([&](const vector<string>& fields, size_t){ rows.push_back(other.row(fields)["id"]); }).select_columns(vector<string>{"id"}).header_row(&other).parse("name,id\na,5\n"));
+  test_expect(other.names() == vector<string>{"id"});
+  test_expect(rows == vector<string>{"5"});
+  auto projected = vector<vector<string>>();
+  test_expect_noexcept(csv::csv_parser([&](const vector<string>& fields, size_t){ projected.push_back(fields); }).select_columns(vector<string>{"price", "id"}).parse("id,name,price\n1,a,10\n"));
+  test_expect(projected == (vector<vector<string>>{{"1", "10"}}));
+  test_expect_except(csv::csv_parser([](const vector<string>&, size_t){}).select_columns(vector<string>{"none"}).parse("id\n1\n"));
+  // Copied header maps keep working (views refer to the own names).
+  const auto copy = header;
+  header.clear();
+  test_expect_eq(copy.column("id"), 1u);
+  test_expect(!copy.contains("name"));
+}
+
+void test_file_scheduler()
+{
+  using namespace std;
+  test_info("Checking csv_file_scheduler against parse_file() of each file ...");
+  auto paths = vector<std::filesystem::path>();
+  for(const auto kb: {1, 3, 2, 200, 1, 40, 5, 1, 90}) {
+    paths.push_back(te::make_random_csv_file("tcsv-sched" + to_string(paths.size()), size_t(kb), 4, ',', "#header\n", 40, te::rnd_pool_ascii_with_newline()));
+  }
+  auto expected = vector<map<size_t, string>>(paths.size());
+  for(size_t i = 0; i < paths.size(); ++i) {
+    csv::csv_parser([&](const vector<string>& fields, size_t line_no){ expected[i][line_no] = te::csv_escape_joined_row_fields(fields, line_no); }, ',', "#").parse_file(paths[i]);
+  }
+  for(const auto num_threads: {size_t(1), size_t(4)}) {
+    auto per_thread = vector<vector<map<size_t, string>>>(num_threads, vector<map<size_t, string>>(paths.size()));
+    auto done_rows = vector<size_t>(paths.size(), 0);
+    auto done_count = vector<size_t>(paths.size(), 0);
+    auto done_mtx = mutex();
+    const auto factory = [&](size_t t) {
+      return [&per_thread, t](size_t file, const vector<string>& fields, size_t line_no){ per_thread[t][file][line_no] = te::csv_escape_joined_row_fields(fields, line_no); };
+    };
+    const auto on_done = [&](size_t file, size_t num_rows, std::exception_ptr error){
+      const auto lck = lock_guard<mutex>(done_mtx);
+      done_rows[file] = num_rows;
+      done_count[file] += error ? 100 : 1;
+    };
+    auto scheduler = csv::csv_file_scheduler(',', "#");
+    scheduler.num_threads(num_threads).pack_size(8 * 1024).split_size(32 * 1024);
+    test_expect_noexcept(scheduler.parse_files(paths, factory, on_done));
+    auto num_mismatches = size_t(0);
+    for(size_t i = 0; i < paths.size(); ++i) {
+      auto parsed = map<size_t, string>();
+      for(const auto& maps: per_thread) parsed.insert(maps[i].begin(), maps[i].end());
+      num_mismatches += (parsed != expected[i]) || (done_rows[i] != expected[i].size()) || (done_count[i] != 1);
+    }
+    test_expect_eq(num_mismatches, 0u);
+  }
+  // Errors: Reported per file, or rethrown without completion handler.
+  auto with_error = paths;
+  with_error.insert(with_error.begin() + 2, "./no-such-file-or-directory.csv");
+  auto failed = vector<size_t>();
+  auto failed_mtx = mutex();
+  const auto no_rows = [](size_t) { return [](size_t, const vector<string>&, size_t){}; };
+  test_expect_noexcept(csv::csv_file_scheduler().num_threads(2).parse_files(with_error, no_rows, [&](size_t file, size_t, std::exception_ptr error){
+    const auto lck = lock_guard<mutex>(failed_mtx);
+    if(error) failed.push_back(file);
+  }));
+  test_expect(failed == vector<size_t>{2});
+  test_expect_except(csv::csv_file_scheduler().num_threads(2).parse_files(with_error, no_rows));
+  for(const auto& path: paths) std::filesystem::remove(path);
+}
+
+void test_scan()
+{
+  using namespace std;
+  test_info("Checking the validation scan against explicit data and parse_file() ...");
+  using error = csv::csv_scan_error;
+  auto parser = csv::csv_parser([](const vector<string>&, size_t){ throw std::runtime_error("row handler invoked"); }, ',', "#", " ");
+  {
+    const auto result = parser.scan("# header\na,b,c\r\n\n\"x\ny\",2,3\n1,2\n\"q\"  ,\"r\"s,t\n4,5,6,7\n\"open,8\n9\n");
+    test_expect(!result.valid());
+    test_expect_eq(result.num_bytes, 62u);
+    test_expect_eq(result.num_rows, 6u);
+    test_expect_eq(result.num_lines, 8u);
+    test_expect_eq(result.min_columns, 1u);
+    test_expect_eq(result.max_columns, 4u);
+    test_expect_eq(result.num_malformed_rows, 4u);
+    test_expect_eq(result.malformed_rows.size(), 4u);
+    if(result.malformed_rows.size() == 4) {
+      const auto& m = result.malformed_rows;
+      test_expect(m[0].row == 2u && m[0].offset == 27u && m[0].line_no == 4u && m[0].error == error::column_count);
+      test_expect(m[1].row == 3u && m[1].offset == 31u && m[1].line_no == 5u && m[1].error == error::data_after_quote);
+      test_expect(m[2].row == 4u && m[2].offset == 44u && m[2].line_no == 6u && m[2].error == error::column_count);
+      test_expect(m[3].row == 5u && m[3].offset == 52u && m[3].line_no == 7u && m[3].error == error::unterminated_quote);
+    }
+    test_expect_eq(parser.scan("a,b\n1,2", 0).num_malformed_rows, 0u);
+    test_expect(parser.scan("a,b\n1,2\n3\n", 0).malformed_rows.empty());
+    test_expect_eq(parser.scan("a,b\n1,2\n3\n", 0).num_malformed_rows, 1u);
+    test_expect_eq(parser.scan("").num_rows, 0u);
+    test_expect_eq(parser.scan("a\nb").num_lines, 2u);
+  }
+  const auto path = te::make_random_csv_file("tcsv-scan", 300, 5, ',', "#header\n", 40, te::rnd_pool_ascii_with_newline());
+  auto num_rows = size_t(0);
+  auto max_line_no = size_t(0);
+  csv::csv_parser([&](const vector<string>& fields, size_t line_no){ ++num_rows; max_line_no = line_no; test_expect_eq(fields.size(), 5u); }, ',', "#").parse_file(path);
+  auto scanner = csv::csv_parser([](const vector<string>&, size_t){}, ',', "#");
+  const auto result = scanner.scan_file(path);
+  test_expect(result.valid());
+  test_expect_eq(result.num_rows, num_rows);
+  test_expect_eq(result.num_lines, max_line_no);
+  test_expect_eq(result.num_bytes, size_t(std::filesystem::file_size(path)));
+  test_expect(result.min_columns == 5u && result.max_columns == 5u);
+  std::filesystem::remove(path);
+}
+
+void test_row_limits()
+{
+  using namespace std;
+  test_info("Checking the row memory limits, limit policies and oversize field streaming ...");
+  auto rows = vector<string>();
+  auto parser = csv::csv_parser([&](const vector<string>& fields, size_t line_no){
+    auto s = to_string(line_no) + ":";
+    for(const auto& field: fields) s += field + "|";
+    rows.push_back(s);
+  });
+  const auto no_limits = csv::csv_row_limits();
+  test_expect(parser.limits().max_field_size == no_limits.max_field_size && parser.limits().policy == csv::csv_limit_policy::error);
+  // Error policy
+  parser.limits({4, 3, 6, csv::csv_limit_policy::error});
+  test_expect_noexcept(parser.parse("abcd,ef\n1,2,3\n"));
+  test_expect_except(parser.parse("a,b\n12345,c\n"));
+  test_expect_except(parser.parse("1,2,3,4\n"));
+  test_expect_except(parser.parse("abc,de,fg\n"));
+  test_expect_except(parser.parse("\"unterminated\n1,2\n"));
+  // Skip policy, also resynchronized in quoted fields, and independent of the chunk boundaries.
+  const auto text = string("a,b\n12345,c\nd,e\n1,2,3,4\n\"ab\ncd\",x\n\"unterminated\nf,g\nhijklm,n\nabc,de,f\nabc,de,fg\n\"\"\"\"\"\"\"\"\"\"\"\"\n\"h\"\"\",i");
+  const auto expected = vector<string>{"1:a|b|", "3:d|e|", "7:f|g|", "9:abc|de|f|", "12:h\"|i|"};
+  parser.limits({4, 3, 6, csv::csv_limit_policy::skip_row});
+  rows.clear();
+  test_expect_noexcept(parser.parse(text));
+  test_expect(rows == expected);
+  test_expect_eq(parser.num_skipped_rows(), 7u);
+  rows.clear();
+  parser.clear();
+  for(const auto& c: text) parser.feed(string_view(&c, 1));
+  parser.finish();
+  test_expect(rows == expected);
+  test_expect_eq(parser.num_skipped_rows(), 7u);
+  // Oversize fields streamed in pieces.
+  auto streamed = string();
+  auto num_last = size_t(0);
+  parser.limits({4, 3, 6, csv::csv_limit_policy::error}).oversize_field_handler([&](string_view data, size_t row, size_t col, bool last){
+    test_expect(row == 1u && col == 1u);
+    streamed += data;
+    num_last += last ? 1 : 0;
+  });
+  rows.clear();
+  test_expect_noexcept(parser.parse("a,b\nc,\"0123\"\"4\n5678\"\"\",d\n"));
+  test_expect(rows == (vector<string>{"1:a|b|", "2:c||d|"}));
+  test_expect_eq(streamed, string("0123\"4\n5678\""));
+  test_expect_eq(num_last, 1u);
+  {
+    // Trim characters: Only the leading ones of the field are skipped, also across chunks.
+    auto pieces = string();
+    auto trimmed = csv::csv_parser([](const vector<string>&, size_t){}, ',', "", " ");
+    trimmed.limits({4, 3, 64, csv::csv_limit_policy::error}).oversize_field_handler([&](string_view data, size_t, size_t, bool){ pieces += data; });
+    const auto quoted = string("x,\"abcdefgh\"\"  ijk\"\n");
+    trimmed.parse(quoted);
+    test_expect_eq(pieces, string("abcdefgh\"  ijk"));
+    pieces.clear();
+    trimmed.clear();
+    for(const auto& c: quoted) trimmed.feed(string_view(&c, 1));
+    trimmed.finish();
+    test_expect_eq(pieces, string("abcdefgh\"  ijk"));
+    pieces.clear();
+    trimmed.clear();
+    trimmed.feed("y,  abcdefgh").feed("   tail,z\n").finish();
+    test_expect_eq(pieces, string("abcdefgh   tail"));
+  }
+  const auto path = te::make_random_csv_file("tcsv-limits", 256, 3, ',', "", 2000, te::rnd_pool_ascii_with_newline());
+  streamed.clear();
+  num_last = 0;
+  auto num_rows = size_t(0);
+  auto max_field_size = size_t(0);
+  parser.oversize_field_handler([&](string_view data, size_t, size_t, bool last){ streamed += data; num_last += last ? 1 : 0; });
+  parser.limits({256, 3, 1024, csv::csv_limit_policy::error});
+  auto sizes = csv::csv_parser([&](const vector<string>& fields, size_t){ ++num_rows; for(const auto& f: fields) max_field_size = std::max(max_field_size, f.size()); });
+  sizes.parse_file(path);
+  test_expect(max_field_size > 256u);
+  rows.clear();
+  test_expect_noexcept(parser.parse_file(path));
+  test_expect_eq(rows.size(), num_rows);
+  test_expect(num_last > 0u);
+  test_expect(streamed.size() > num_last * 256u);
+  parser.oversize_field_handler(nullptr);
+  test_expect_except(parser.parse_file(path));
+  std::filesystem::remove(path);
+}
+
+void test_row_index()
+{
+  using namespace std;
+  test_info("Checking build_row_index() and row range parse_file() against parse_file() ...");
+  using parser_type = csv::detail::basic_parser<1, string, vector<string>>; // Small chunks (1kb, rounded up to 4kb)
+  const auto path = te::make_random_csv_file("tcsv-rowindex", 128, 4, ',', "#header\n#comment", 30, te::rnd_pool_ascii_with_newline());
+  const auto index_path = std::filesystem::path(path.string() + ".idx");
+  auto rows = vector<string>();
+  auto parsed = string();
+  const auto all_rows_proc = [&](const vector<string>& fields, size_t line_no) {
+    rows.push_back(te::csv_escape_joined_row_fields(fields, line_no) + "\n");
+  };
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(parser_type(all_rows_proc, ',', "#").parse_file(path));
+  test_expect(rows.size() > 100);
+  for(const auto rows_per_entry: {size_t(1), size_t(7), size_t(64), size_t(100000)}) {
+    auto parser = parser_type(row_proc, ',', "#");
+    parsed.clear();
+    const auto built = parser.build_row_index(path, rows_per_entry);
+    test_expect(built.num_rows() == rows.size());
+    test_expect(built.file_size() == size_t(std::filesystem::file_size(path)));
+    test_expect(built.size() == (rows.size() + rows_per_entry - 1) / rows_per_entry);
+    test_expect(parsed.empty()); // Row handler not invoked while indexing.
+    test_expect_noexcept(built.save(index_path));
+    const auto index = csv::csv_row_index::load(index_path);
+    test_expect(index.size() == built.size());
+    test_expect(index.num_rows() == built.num_rows());
+    for(size_t i = 0; i < 20; ++i) {
+      const auto first = sw::utest::random<size_t>(0, rows.size() + 2);
+      const auto num = sw::utest::random<size_t>(0, 300);
+      auto expected = string();
+      for(size_t r = first; (r < rows.size()) && (r < first + num); ++r) expected += rows[r];
+      parsed.clear();
+      test_expect_noexcept(parser.parse_file(path, index, first, num));
+      if(!test_expect_cond(parsed == expected)) {
+        test_note("rows_per_entry=" << rows_per_entry << ", first=" << first << ", num=" << num);
+        break;
+      }
+    }
+    parsed.clear();
+    test_expect_noexcept(parser.parse_file(path, index, 0, rows.size()));
+    test_expect(parsed == std::accumulate(rows.begin(), rows.end(), string()));
+  }
+  {
+    test_info("Checking row range parse_file() with a header row and a column selection by name ...");
+    const auto header_path = te::make_random_csv_file("tcsv-rowindex-header", 64, 4, ',', "#comment\nc1,c2,c3,c4", 30, te::rnd_pool_ascii_with_newline());
+    const auto names = vector<string>{"c3", "c1"};
+    rows.clear();
+    test_expect_noexcept(parser_type(all_rows_proc, ',', "#").select_columns(names).parse_file(header_path));
+    test_expect(rows.size() > 100);
+    auto header = csv::csv_header();
+    auto parser = parser_type(row_proc, ',', "#");
+    parser.select_columns(names).header_row(&header);
+    const auto index = parser.build_row_index(header_path, 7);
+    test_expect(index.num_rows() == rows.size() + 1); // Data row 0 is the header row.
+    for(size_t i = 0; i < 20; ++i) {
+      const auto first = sw::utest::random<size_t>(1, rows.size());
+      const auto num = sw::utest::random<size_t>(1, 50);
+      auto expected = string();
+      for(size_t r = first - 1; (r < rows.size()) && (r < first - 1 + num); ++r) expected += rows[r];
+      parsed.clear();
+      header = csv::csv_header();
+      test_expect_noexcept(parser.parse_file(header_path, index, first, num));
+      test_expect_eq(header.size(), 2u);
+      if(!test_expect_cond(parsed == expected)) {
+        test_note("first=" << first << ", num=" << num);
+        break;
+      }
+    }
+    std::filesystem::remove(header_path);
+  }
+  // Mismatching file or invalid index files.
+  const auto index = parser_type(row_proc, ',', "#").build_row_index(path, 16);
+  {
+    auto fos = std::ofstream(path, std::ios::binary | std::ios::app);
+    fos << "a,b,c,d\n";
+  }
+  test_expect_except(parser_type(row_proc, ',', "#").parse_file(path, index, 0, 10));
+  {
+    auto fos = std::ofstream(index_path, std::ios::binary);
+    fos << "csv-row-index 1\n16 100 2000 1\n0 0 0\n";
+  }
+  test_expect_except(csv::csv_row_index::load(index_path));
+  test_expect_except(csv::csv_row_index::load("./no-such-file-or-directory.idx"));
+  test_expect_except(csv::csv_row_index(0));
+  std::filesystem::remove(index_path);
+  std::filesystem::remove(path);
+}
+
+void test_static_dialect()
+{
+  using namespace std;
+  test_info("Checking csv_dialect_parser against csv_parser with the same run-time settings ...");
+  using dialect_type = csv::csv_dialect<';', true, csv::csv_chars<'#'>, csv::csv_chars<' ', '\t'>>;
+  static_assert(dialect_type::delimiter() == ';');
+  static_assert(dialect_type::is_trim_char('\t') && dialect_type::is_trim_char(' ') && !dialect_type::is_trim_char(';'));
+  static_assert(dialect_type::is_comment_char('#') && !dialect_type::is_comment_char(' '));
+  static_assert(!csv::csv_dialect<','>::has_trim_chars() && !csv::csv_dialect<','>::has_comment_chars());
+  static_assert(csv::csv_dialect<'\t', true, csv::csv_chars<>, csv::csv_chars<'\t', ' '>>::char_class('\t') == (csv::detail::cc_delimiter | csv::detail::cc_trim));
+  static_assert(csv::csv_dialect<',', false>::char_class('"') == csv::detail::cc_other);
+  static_assert(csv::detail::make_char_class_table(',', true, "#", " ")[uint8_t('\r')] == csv::detail::cc_newline);
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ';');
+  auto csv_text = string("# comment\n#\n");
+  for(size_t row = 0; row < 500; ++row) {
+    csv_text += te::make_random_csv_row(composer, sw::utest::random<size_t>(1, 6), 20, te::rnd_pool_ascii_with_newline() + " \t");
+  }
+  auto expected = string();
+  auto parsed = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(csv::csv_parser(expected_proc, ';', "#", " \t").parse(csv_text));
+  test_expect_noexcept(csv::csv_dialect_parser<dialect_type>(row_proc).parse(csv_text));
+  test_expect(!expected.empty());
+  test_expect(parsed == expected);
+  parsed.clear();
+  auto inline_parser = csv::csv_dialect_parser<dialect_type, decltype(row_proc)>(row_proc);
+  for(size_t pos = 0; pos < csv_text.size(); pos += 13) {
+    test_expect_noexcept(inline_parser.feed(string_view(csv_text).substr(pos, 13)));
+  }
+  test_expect_noexcept(inline_parser.finish());
+  test_expect(parsed == expected);
+  // Quoting disabled: Quotes are normal characters.
+  auto rows = vector<vector<string>>();
+  const auto collect = [&](const vector<string>& fields, size_t) { rows.push_back(fields); };
+  test_expect_noexcept(csv::csv_dialect_parser<csv::csv_dialect<',', false>>(collect).parse("a,\"b,c\"\n\"\"\n"));
+  test_expect(rows == (vector<vector<string>>{{"a", "\"b", "c\""}, {"\"\""}}));
+}
+
+void test_trim_padded_fields()
+{
+  using namespace std;
+  test_info("Checking trimming of padded fields against explicit data and csv_view_parser ...");
+  auto rows = vector<vector<string>>();
+  const auto collect = [&](const vector<string>& fields, size_t) { rows.push_back(fields); };
+  test_expect_noexcept(csv::csv_parser(collect, ',', "", " \t").parse("  a  ,\t b\t,   \n   \n\n \" x \" , \"\" , \"y\"z  \n"));
+  test_expect(rows == (vector<vector<string>>{{"a", "b", ""}, {""}, {"\" x \"", "\"\"", "\"y\"z"}})); // Quotes after padding are normal characters.
+  // Fixed-width padded fields, compared with the view parser (trimming views).
+  auto csv_text = string();
+  for(size_t row = 0; row < 500; ++row) {
+    for(size_t col = 0; col < 6; ++col) {
+      const auto field = te::make_random_csv_row(csv::csv_composer(csv::csv_composer::no_output, ','), 1, 12, te::rnd_pool_ascii() + " ");
+      csv_text += string(sw::utest::random<size_t>(0, 8), ' ') + field.substr(0, field.size() - 2) + string(sw::utest::random<size_t>(0, 8), ' ');
+      csv_text += (col < 5) ? "," : "\n";
+    }
+    if(row % 11 == 0) csv_text += "      \n";
+  }
+  auto expected = string();
+  auto parsed = string();
+  const auto view_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(csv::csv_view_parser(view_proc, ',', "", " ").parse(csv_text));
+  test_expect_noexcept(csv::csv_parser(row_proc, ',', "", " ").parse(csv_text));
+  test_expect(!expected.empty());
+  test_expect(parsed == expected);
+}
+
+void test_feed_string_view()
+{
+  using namespace std;
+  test_info("Checking csv_parser::feed() with caller-owned, reused chunk buffers ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  auto csv_text = string("# comment\r\n\r\n");
+  for(size_t row = 0; row < 300; ++row) {
+    csv_text += te::make_random_csv_row(composer, sw::utest::random<size_t>(1, 6), 20, te::rnd_pool_ascii_with_newline() + "  ");
+    if(row % 7 == 0) csv_text += "\r\n";
+  }
+  auto expected = string();
+  auto parsed = string();
+  const auto expected_proc = joined_rows_to(expected);
+  const auto row_proc = joined_rows_to(parsed);
+  test_expect_noexcept(csv::csv_parser(expected_proc, ',', "#", " ").parse(csv_text));
+  auto parser = csv::csv_parser(row_proc, ',', "#", " ");
+  auto buffer = array<char, 64>();
+  for(size_t pos = 0; pos < csv_text.size();) {
+    const auto n = std::min(csv_text.size() - pos, sw::utest::random<size_t>(1, buffer.size()));
+    std::copy_n(csv_text.begin() + std::ptrdiff_t(pos), n, buffer.begin());
+    parser.feed(string_view(buffer.data(), n));
+    buffer.fill('"'); // Invalidate the chunk data after the feed.
+    pos += n;
+  }
+  parser.finish();
+  test_expect(!expected.empty());
+  test_expect(parsed == expected);
+}
+
+void test_parser_stats()
+{
+  using namespace std;
+  test_info("Checking csv_instrumented_parser statistics against explicit data and chunked feeding ...");
+  {
+    auto parser = csv::csv_instrumented_parser([](const vector<string>&, size_t){}, ',', "#", " ");
+    test_expect_noexcept(parser.parse("# header\na, \"b\"\"c\" ,d\r\n\n\"x\ny\"\n  1234567  \n"));
+    const auto& stats = parser.stats();
+    test_expect_eq(stats.num_chunks, 1u);
+    test_expect_eq(stats.num_bytes, 42u);
+    test_expect_eq(stats.max_chunk_size, 42u);
+    test_expect_eq(stats.num_rows, 3u);
+    test_expect_eq(stats.num_fields, 5u);
+    test_expect_eq(stats.num_quoted_fields, 1u); // The quote after the space is a normal character.
+    test_expect_eq(stats.max_field_size, 7u);
+    test_expect_eq(stats.max_row_size, 12u);
+    test_expect_eq(stats.max_row_fields, 3u);
+    test_expect_eq(stats.num_split_rows, 0u);
+    parser.stats().clear();
+    test_expect_eq(parser.stats().num_rows, 0u);
+  }
+  // Chunked feeding: Same row and field counts, all chunks registered.
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  auto csv_text = string();
+  for(size_t row = 0; row < 300; ++row) {
+    csv_text += te::make_random_csv_row(composer, sw::utest::random<size_t>(1, 6), 30, te::rnd_pool_ascii_with_newline());
+  }
+  auto num_rows = size_t(0);
+  auto num_fields = size_t(0);
+  auto max_field_size = size_t(0);
+  const auto row_proc = [&](const vector<string>& fields, size_t) {
+    ++num_rows;
+    num_fields += fields.size();
+    for(const auto& field:fields) max_field_size = std::max(max_field_size, field.size());
+  };
+  auto whole = csv::csv_instrumented_parser(row_proc);
+  whole.parse(csv_text);
+  auto chunked = csv::csv_instrumented_parser([](const vector<string>&, size_t){});
+  auto num_chunks = size_t(0);
+  for(size_t pos = 0; pos < csv_text.size(); ++num_chunks) {
+    const auto n = std::min(csv_text.size() - pos, sw::utest::random<size_t>(1, 100));
+    chunked.feed(string_view(csv_text).substr(pos, n));
+    pos += n;
+  }
+  chunked.finish();
+  test_expect_eq(whole.stats().num_rows, num_rows);
+  test_expect_eq(whole.stats().num_fields, num_fields);
+  test_expect_eq(whole.stats().max_field_size, max_field_size);
+  test_expect_eq(chunked.stats().num_chunks, num_chunks);
+  test_expect_eq(chunked.stats().num_bytes, csv_text.size());
+  test_expect_eq(chunked.stats().num_rows, num_rows);
+  test_expect_eq(chunked.stats().num_fields, num_fields);
+  test_expect_eq(chunked.stats().num_quoted_fields, whole.stats().num_quoted_fields);
+  test_expect_eq(chunked.stats().max_field_size, max_field_size);
+  test_expect_eq(chunked.stats().max_row_size, whole.stats().max_row_size);
+  test_expect(chunked.stats().num_split_rows > 0);
+}
+
+void test_quote_free_chunks()
+{
+  using namespace std;
+  test_info("Checking the quote-free chunk fast path against csv_view_parser with mixed chunks ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  const auto newlines = array<string, 4>{"\n", "\r\n", "\r", "\n\n"};
+  auto csv_text = string();
+  for(size_t row = 0; row < 400; ++row) {
+    const auto quoted = (row % 50) == 49; // Some chunks contain quotes (state machine), most do not.
+    auto line = te::make_random_csv_row(composer, sw::utest::random<size_t>(1, 8), 12, (quoted ? string("\",\n") : string()) + "abcdefghijklm ,");
+    line.resize(line.size() - 2);
+    csv_text += line + newlines[sw::utest::random<size_t>(0, newlines.size()-1)];
+  }
+  for(const auto trim: {string_view(""), string_view(" ")}) {
+    auto expected = string();
+    auto parsed = string();
+    const auto view_proc = joined_rows_to(expected);
+    const auto row_proc = joined_rows_to(parsed);
+    test_expect_noexcept(csv::csv_view_parser(view_proc, ',', "", trim).parse(csv_text));
+    auto parser = csv::csv_parser(row_proc, ',', "", trim);
+    for(size_t pos = 0; pos < csv_text.size();) {
+      const auto n = std::min(csv_text.size() - pos, sw::utest::random<size_t>(1, 200));
+      parser.feed(string_view(csv_text).substr(pos, n));
+      pos += n;
+    }
+    parser.finish();
+    test_expect(!expected.empty());
+    test_expect(parsed == expected);
+  }
+  // A '\0' in string view data is field data, independent of the chunking,
+  // as for the view parser (only a moved owned string stops there).
+  const auto nul_data = string("a,b\nc,d\0e\n\"f\0\",g\n", 17);
+  const auto nul_expected = vector<vector<string>>{{"a", "b"}, {"c", string("d\0e", 3)}, {string("f\0", 2), "g"}};
+  auto rows = vector<vector<string>>();
+  const auto row_proc = [&](const vector<string>& fields, size_t) { rows.push_back(fields); };
+  test_expect_noexcept(csv::csv_parser(row_proc).parse(string_view(nul_data)));
+  test_expect(rows == nul_expected);
+  rows.clear();
+  auto chunked = csv::csv_parser(row_proc);
+  for(size_t i=0; i<nul_data.size(); ++i) chunked.feed(string_view(nul_data).substr(i, 1));
+  chunked.finish();
+  test_expect(rows == nul_expected);
+  rows.clear();
+  csv::csv_view_parser([&](const vector<string_view>& fields, size_t) { rows.emplace_back(fields.begin(), fields.end()); }).parse(nul_data);
+  test_expect(rows == nul_expected);
+  rows.clear();
+  test_expect_noexcept(csv::csv_parser(row_proc).parse(string(nul_data)));
+  test_expect(rows == (vector<vector<string>>{{"a", "b"}, {"c", "d"}}));
+}
+
 void test(const std::vector<std::string>&)
 {
+  test_inline_row_handler();
+  test_feed_string_view();
+  test_quote_free_chunks();
+  test_pooled_parser();
+  test_column_projection();
+  test_find_first_of();
   test_fopen_error();
+  test_parse_file_pipelined();
+  test_read_buffer_size();
+  test_header_row();
+  test_file_scheduler();
+  test_scan();
+  test_row_limits();
+  test_row_index();
+  test_static_dialect();
+  test_trim_padded_fields();
+  test_parser_stats();
   test_parse_string_stop_at_nulchar();
   test_parse_cmpfile_all("data/comma-notrim", ',', "", "");
   test_parse_cmpfile_all("data/comma-trimsp", ',', "", "\t ");
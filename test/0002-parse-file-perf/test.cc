@@ -6,6 +6,9 @@
  * sized (actual files may be a little bigger),
  * and measures the parsing time including
  * file i/o handling. Column count is random.
+ * Measured are `csv_parser`, `csv_inline_parser`,
+ * `csv_dialect_parser`, and `csv_view_parser` (sequential
+ * and `parse_file_parallel()`).
  *
  * Repeats the measurements and prints the summary.
  *
@@ -26,25 +29,29 @@
 #include <memory>
 #include <string>
 #include <chrono>
+#include <atomic>
 
-double test_perf_cycle(std::filesystem::path path)
+template<typename ParseFunction>
+double test_perf_cycle(std::filesystem::path path, const ParseFunction& parse)
 {
   using namespace std;
 
-  auto accumulated_content_length = size_t(0);
-  const auto read_fields = [&](const std::vector<std::string>& fields, size_t line_no) {
-    for(const auto& s: fields) accumulated_content_length += s.size();
+  auto accumulated_content_length = atomic<size_t>(0); // Atomic for the concurrent row handler of `parse_file_parallel()`.
+  const auto read_fields = [&](const auto& fields, size_t line_no) {
+    auto n = size_t(0);
+    for(const auto& s: fields) n += s.size();
+    accumulated_content_length += n;
     (void)line_no;
   };
 
   const auto start_time = chrono::high_resolution_clock::now();
   double bytes_processed = double(filesystem::file_size(path));
-  test_expect_noexcept(csv::csv_parser(read_fields, ',').parse_file(path));
+  test_expect_noexcept(parse(path, read_fields));
   const auto test_time = chrono::high_resolution_clock::now() - start_time;
   const auto secs = 1e-6 + double(chrono::duration_cast<chrono::milliseconds>(test_time).count()) * 1e-3;
   static constexpr double mb_scale = 1.0 / (1024 * 1024);
   const auto mbytes_per_sec = (bytes_processed / secs) * mb_scale;
-  test_note("String sizes of all cells accumulated: " << long(accumulated_content_length) << ".");
+  test_note("String sizes of all cells accumulated: " << long(accumulated_content_length.load()) << ".");
   test_note("Test time:" << secs << ", payload:" << long(bytes_processed * mb_scale) << "MB, MB/s: " << mbytes_per_sec);
   return mbytes_per_sec;
 }
@@ -85,14 +92,22 @@ void test(const std::vector<std::string>& args)
       csv_header,
       csv_max_field_length,
       std::string(csv_field_character_pool));
-    auto stats = std::vector<double>();
-    for(int i = num_pref_test_iterations; i; --i) {
-      test_expect_noexcept(stats.push_back(test_perf_cycle(csv_file_path)));
-    }
-    const auto mean_time = std::accumulate(stats.begin(), stats.end(), double(0), [](auto a, auto b) { return a + b; })
-                           / double(stats.size());
-    test_info("Average rate:", mean_time, "MB/s");
-    perf_summary.push_back(to_string(mean_time) + string("MB/s : ") + csv_file_path.filename().string());
+    const auto mean_rate = [&](const auto& parse, const std::string& name) {
+      auto stats = std::vector<double>();
+      for(int i = num_pref_test_iterations; i; --i) {
+        test_expect_noexcept(stats.push_back(test_perf_cycle(csv_file_path, parse)));
+      }
+      const auto mean_time = std::accumulate(stats.begin(), stats.end(), double(0), [](auto a, auto b) { return a + b; })
+                             / double(stats.size());
+      test_info("Average rate (", name, "):", mean_time, "MB/s");
+      perf_summary.push_back(to_string(mean_time) + string("MB/s : ") + csv_file_path.filename().string() + " (" + name + ")");
+    };
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_parser(on_row, ',').parse_file(path); }, "csv_parser");
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_inline_parser<std::decay_t<decltype(on_row)>>(on_row, ',').parse_file(path); }, "csv_inline_parser");
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_dialect_parser<csv::csv_dialect<','>, std::decay_t<decltype(on_row)>>(on_row).parse_file(path); }, "csv_dialect_parser, inline");
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_parser(on_row, ',').parse_file_pipelined(path); }, "csv_parser, pipelined");
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_view_parser(on_row, ',').parse_file(path); }, "csv_view_parser");
+    mean_rate([](const auto& path, const auto& on_row) { csv::csv_view_parser(on_row, ',').parse_file_parallel(path); }, "csv_view_parser, parallel");
     if((sw::utest::test::num_fails() == 0) && filesystem::is_regular_file(csv_file_path)) {
       test_info("Removing tmp file ", csv_file_path);
       filesystem::remove(csv_file_path);
@@ -8,6 +8,7 @@
 #include <include/csv.hh>
 #include <unordered_set>
 #include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -149,10 +150,217 @@ void test_compose_fixed()
   }
 }
 
+void test_compose_blocks()
+{
+  using namespace std;
+  using namespace csv;
+  test_info("Checking `csv_composer` block output against line-wise output ...");
+  const auto rnd_pool = te::rnd_pool_ascii_with_newline() + "\"  ,;";
+  auto rows = vector<vector<string>>();
+  for(int i = 0; i < 500; ++i) {
+    auto row = vector<string>();
+    for(int col = 0; col < 4; ++col) {
+      auto s = string(sw::utest::random<size_t>(0, 16), ' ');
+      for(auto& c: s) c = rnd_pool[sw::utest::random<size_t>(0, rnd_pool.size()-1)];
+      row.push_back(s);
+    }
+    rows.push_back(row);
+  }
+  auto expected = string();
+  auto num_lines = size_t(0);
+  {
+    auto composer = csv_composer([&](const string& line) { expected += line; ++num_lines; }, ',', "\n");
+    composer.define_columns(4, array{2});
+    for(const auto& row: rows) composer.feed(row);
+    test_expect_eq(num_lines, rows.size());
+    test_expect_noexcept(composer.flush());
+    test_expect_eq(num_lines, rows.size());
+  }
+  for(const auto block_size: {size_t(1), size_t(100), size_t(4096), size_t(1024*1024)}) {
+    auto composed = string();
+    auto num_blocks = size_t(0);
+    auto composer = csv_composer([&](const string& block) {
+      if(!block.empty()) ++num_blocks;
+      composed += block;
+    }, ',', "\n", block_size);
+    composer.define_columns(4, array{2});
+    for(const auto& row: rows) {
+      composer.feed(row);
+      if(&row == &rows[rows.size()/2]) {
+        test_expect_except(composer.feed(array{"1", "2", "3"}));
+        test_expect_except(composer.feed(array{"1", "2", "3", "4", "5"}));
+      }
+    }
+    test_expect_noexcept(composer.flush());
+    test_expect_noexcept(composer.flush());
+    test_note("Block size " << block_size << ": " << num_blocks << " blocks");
+    test_expect(composed == expected);
+    test_expect((num_blocks <= rows.size()) && ((block_size > expected.size()) == (num_blocks == 1)));
+  }
+  {
+    // Unflushed lines are discarded by `clear()`.
+    auto composed = string();
+    auto composer = csv_composer([&](const string& block) { composed += block; }, ',', "\n", 4096);
+    composer.define_columns(2).feed(array{"a", "b"});
+    test_expect_noexcept(composer.clear());
+    composer.define_columns(2).feed(array{"c", "d"});
+    test_expect_noexcept(composer.flush());
+    test_expect(composed == "c,d\n");
+  }
+}
+
+void test_compose_parallel()
+{
+  using namespace std;
+  using namespace csv;
+  test_info("Checking `csv_composer::feed_parallel()` against sequential output ...");
+  const auto rnd_pool = te::rnd_pool_ascii_with_newline() + "\"  ,;";
+  auto rows = vector<vector<string>>();
+  for(int i = 0; i < 3000; ++i) {
+    auto row = vector<string>();
+    for(int col = 0; col < 5; ++col) {
+      auto s = string(sw::utest::random<size_t>(0, 16), ' ');
+      for(auto& c: s) c = rnd_pool[sw::utest::random<size_t>(0, rnd_pool.size()-1)];
+      row.push_back(s);
+    }
+    rows.push_back(row);
+  }
+  auto expected = string();
+  {
+    auto composer = csv_composer([&](const string& line) { expected += line; }, ',', "\n");
+    composer.define_columns(5, array{3});
+    for(const auto& row: rows) composer.feed(row);
+  }
+  for(const auto num_threads: {size_t(0), size_t(1), size_t(2), size_t(5)}) {
+    for(const auto rows_per_block: {size_t(1), size_t(7), size_t(256), size_t(10000)}) {
+      auto composed = string();
+      auto num_blocks = size_t(0);
+      auto composer = csv_composer([&](const string& block) { composed += block; ++num_blocks; }, ',', "\n");
+      composer.define_columns(5, array{3});
+      test_expect_noexcept(composer.feed(rows.front()));
+      test_expect_noexcept(composer.feed_parallel(vector<vector<string>>(rows.begin() + 1, rows.end()), num_threads, rows_per_block));
+      if(!test_expect_cond(composed == expected)) {
+        test_note("num_threads=" << num_threads << ", rows_per_block=" << rows_per_block);
+      }
+      test_expect_eq(num_blocks, 1 + (rows.size() - 1 + rows_per_block - 1) / rows_per_block);
+    }
+  }
+  // Row generator, errors in the generated rows and the output function.
+  {
+    auto composed = string();
+    auto composer = csv_composer([&](const string& block) { composed += block; }, ',', "\n");
+    composer.define_columns(5, array{3});
+    const auto row_of = [&](size_t i) -> const vector<string>& { return rows[i]; };
+    test_expect_noexcept(composer.feed_parallel(rows.size(), row_of, 3, 100));
+    test_expect(composed == expected);
+    composed.clear();
+    const auto bad_row_of = [&](size_t i) { return (i == 1234) ? vector<string>{"1", "2"} : rows[i]; };
+    test_expect_except(composer.feed_parallel(rows.size(), bad_row_of, 3, 100));
+    test_expect(composed.size() < expected.size());
+    test_expect(composed == expected.substr(0, composed.size()));
+    composed.clear();
+    test_expect_except(composer.feed_parallel(rows.size(), bad_row_of, 1, 100));
+    test_expect(composed == expected.substr(0, composed.size()));
+    test_expect_except(composer.feed_parallel(rows.size(), row_of, 2, 0));
+    auto num_blocks = size_t(0);
+    auto failing_composer = csv_composer([&](const string&) { if(++num_blocks == 3) throw runtime_error("output error"); }, ',', "\n");
+    failing_composer.define_columns(5);
+    test_expect_except(failing_composer.feed_parallel(rows, 4, 10));
+    test_expect_eq(num_blocks, size_t(3));
+  }
+}
+
+void test_contains_quote_chars()
+{
+  using namespace std;
+  test_info("Checking quoting need detection `csv::detail::contains_quote_chars()` ...");
+  const auto reference = [](string_view text, char delim) {
+    for(const auto c: text) {
+      if((c < ' ') || (c == '"') || (c > '~') || (c == delim)) return true;
+    }
+    return false;
+  };
+  auto num_mismatches = size_t(0);
+  auto num_quoted = size_t(0);
+  for(int i = 0; i < 20000; ++i) {
+    auto text = string(sw::utest::random<size_t>(0, 100), 'a');
+    for(auto& c: text) c = char(sw::utest::random<int>(' ', '~'));
+    if((!text.empty()) && (sw::utest::random<int>(0, 1) == 0)) {
+      text[sw::utest::random<size_t>(0, text.size()-1)] = char(sw::utest::random<int>(-128, 127));
+    }
+    const auto delim = (i & 1) ? ';' : ',';
+    const auto expected = reference(text, delim);
+    num_quoted += expected ? 1 : 0;
+    if(csv::detail::contains_quote_chars(text.data(), text.data() + text.size(), delim) != expected) {
+      if(++num_mismatches < 10) test_note("Mismatch: '" << text << "'");
+    }
+  }
+  test_note("Texts needing quotes: " << num_quoted);
+  test_expect_eq(num_mismatches, size_t(0));
+}
+
+void test_compose_typed()
+{
+  using namespace std;
+  using namespace csv;
+  test_info("Checking `csv_composer::feed_values()` and tuple `feed()` against string fields ...");
+  {
+    auto out = string();
+    auto composer = csv_composer([&](const string& line) { out += line; }, ',', "\n");
+    composer.define_columns(5, array{5});
+    composer.feed_values(1, -42L, 0.1, "a,b", 7u);
+    composer.feed(make_tuple(uint8_t(255), 1e300, -0.0f, string(" x"), string_view("y")));
+    composer.feed_values(std::numeric_limits<int64_t>::min(), std::numeric_limits<double>::infinity(), 2.5, "", std::numeric_limits<uint64_t>::max());
+    test_expect_eq(out, "1,-42,0.1,\"a,b\",\"7\"\n255,1e+300,-0,\" x\",\"y\"\n-9223372036854775808,inf,2.5,,\"18446744073709551615\"\n");
+    test_expect_except(composer.feed_values(1, 2, 3, 4));
+    test_expect_except(composer.feed_values(1, 2, 3, 4, 5, 6));
+    test_expect_except(composer.feed(make_tuple(1, 2)));
+  }
+  {
+    auto out = string();
+    auto composer = csv_composer([&](const string& line) { out += line; }, '.', "\n");
+    composer.define_columns(3);
+    composer.feed_values(1.5, 2, "c");
+    test_expect_eq(out, "\"1.5\".2.c\n"); // Delimiter in a number.
+  }
+  // Random values: Same output as string fields, and the doubles round-trip.
+  auto expected = string();
+  auto composed = string();
+  auto strings = csv_composer([&](const string& line) { expected += line; }, ';', "\n");
+  auto typed = csv_composer([&](const string& line) { composed += line; }, ';', "\n", 4096);
+  strings.define_columns(4);
+  typed.define_columns(4);
+  auto values = vector<double>();
+  for(int i = 0; i < 1000; ++i) {
+    const auto n = sw::utest::random<int64_t>(std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max());
+    const auto u = sw::utest::random<uint32_t>(0, std::numeric_limits<uint32_t>::max());
+    const auto d = double(n) / double(sw::utest::random<int64_t>(1, 1000000)) * ((i % 3) ? 1e-9 : 1e9);
+    values.push_back(d);
+    auto buffer = array<char, 64>();
+    const auto end = to_chars(buffer.data(), buffer.data() + buffer.size(), d).ptr;
+    strings.feed(array<string, 4>{to_string(n), to_string(u), string(buffer.data(), end), "t\"" + to_string(i)});
+    typed.feed_values(n, u, d, "t\"" + to_string(i));
+  }
+  typed.flush();
+  test_expect(!expected.empty());
+  test_expect(composed == expected);
+  auto parsed = vector<double>();
+  csv::csv_parser([&](const vector<string>& fields, size_t){
+    auto d = 0.0;
+    from_chars(fields[2].data(), fields[2].data() + fields[2].size(), d);
+    parsed.push_back(d);
+  }, ';').parse(composed);
+  test_expect(parsed == values);
+}
+
 void test(const std::vector<std::string>&)
 {
   test_escaping_fixed();
   test_quoting_fixed();
+  test_contains_quote_chars();
   test_env_makerandom_file();
   test_compose_fixed();
+  test_compose_blocks();
+  test_compose_parallel();
+  test_compose_typed();
 }
@@ -0,0 +1,528 @@
+/**
+ * @test parse-view
+ *
+ * Checks csv::csv_view_parser against known
+ * results and against csv::csv_parser with
+ * randomly generated CSV data, which is fed
+ * in random chunk sizes.
+ */
+#include <testenv.hh>
+#include <include/csv.hh>
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+#include <limits>
+#include <tuple>
+
+namespace {
+
+  std::string joined_rows_of_parser(
+    const std::string& csv_text,
+    const char delim,
+    const std::string_view comment_chars,
+    const std::string_view trim_chars)
+  {
+    auto rows = std::string();
+    const auto row_proc = [&](const std::vector<std::string>& fields, size_t line_no) {
+      rows += te::csv_escape_joined_row_fields(fields, line_no) + "\n";
+    };
+    csv::csv_parser(row_proc, delim, comment_chars, trim_chars).parse(csv_text);
+    return rows;
+  }
+
+  std::string joined_rows_of_chunked_parser(
+    const std::string& csv_text,
+    const char delim,
+    const std::string_view comment_chars,
+    const std::string_view trim_chars,
+    const size_t max_chunk_size)
+  {
+    auto rows = std::string();
+    const auto row_proc = [&](const std::vector<std::string>& fields, size_t line_no) {
+      rows += te::csv_escape_joined_row_fields(fields, line_no) + "\n";
+    };
+    auto parser = csv::csv_parser(row_proc, delim, comment_chars, trim_chars);
+    auto text = std::string_view(csv_text);
+    while(!text.empty()) {
+      const auto n = std::min(text.size(), sw::utest::random<size_t>(1, max_chunk_size));
+      parser.feed(text.substr(0, n));
+      text.remove_prefix(n);
+    }
+    parser.finish();
+    return rows;
+  }
+
+  std::string joined_rows_of_view_parser(
+    const std::string& csv_text,
+    const char delim,
+    const std::string_view comment_chars,
+    const std::string_view trim_chars,
+    const size_t max_chunk_size)
+  {
+    auto rows = std::string();
+    const auto row_proc = [&](const std::vector<std::string_view>& fields, size_t line_no) {
+      rows += te::csv_escape_joined_row_fields(std::vector<std::string>(fields.begin(), fields.end()), line_no) + "\n";
+    };
+    auto parser = csv::csv_view_parser(row_proc, delim, comment_chars, trim_chars);
+    auto text = std::string_view(csv_text);
+    while(!text.empty()) {
+      const auto n = std::min(text.size(), sw::utest::random<size_t>(1, max_chunk_size));
+      parser.feed(text.substr(0, n));
+      text.remove_prefix(n);
+    }
+    parser.finish();
+    return rows;
+  }
+
+}
+
+void test_view_parse_fixed()
+{
+  using namespace std;
+  test_info("Checking csv_view_parser with fixed data ...");
+
+  auto rows = vector<vector<string>>();
+  auto line_numbers = vector<size_t>();
+  auto num_views_into_input = size_t(0);
+  auto input = string();
+
+  const auto row_proc = [&](const vector<string_view>& fields, size_t line_no) {
+    rows.emplace_back(fields.begin(), fields.end());
+    line_numbers.push_back(line_no);
+    for(const auto& field: fields) {
+      if(field.empty()) continue;
+      if((field.data() >= input.data()) && (field.data() < input.data() + input.size())) ++num_views_into_input;
+    }
+  };
+
+  input = "a,bc,def\n"                 // 1: plain
+          "\"a\",\"b,c\",\"d\"\"ef\"\r\n"  // 2: quoted, with escape
+          "\r\n"                        // 3: empty line
+          "\"\"\n"                      // 4: empty quoted field, ignored like empty lines.
+          "x,\"y\"z,\"\"\n"             // 5: trailing unquoted data after closing quote.
+          "last";                       // 6: no newline at the end.
+
+  test_expect_noexcept(csv::csv_view_parser(row_proc).parse(input));
+  test_expect_eq(rows.size(), size_t(4));
+  if(rows.size() != 4) return;
+  test_expect(rows[0] == (vector<string>{"a", "bc", "def"}));
+  test_expect(rows[1] == (vector<string>{"a", "b,c", "d\"ef"}));
+  test_expect(rows[2] == (vector<string>{"x", "yz", ""}));
+  test_expect(rows[3] == (vector<string>{"last"}));
+  test_expect(line_numbers == (vector<size_t>{1, 2, 5, 6}));
+  test_info("Non-empty fields referring to the input data: ", num_views_into_input);
+  test_expect_eq(num_views_into_input, size_t(3 + 2 + 1));  // Unescaped fields, except in the unfinished last line.
+
+  test_info("Checking CR/LF split over two chunks ...");
+  rows.clear();
+  line_numbers.clear();
+  {
+    auto parser = csv::csv_view_parser(row_proc);
+    parser.feed("1,2\r");
+    parser.feed("\n3,\"4\"");
+    parser.feed("\",5\"\n");
+    parser.finish();
+  }
+  test_expect_eq(rows.size(), size_t(2));
+  if(rows.size() != 2) return;
+  test_expect(rows[0] == (vector<string>{"1", "2"}));
+  test_expect(rows[1] == (vector<string>{"3", "4\",5"}));
+  test_expect(line_numbers == (vector<size_t>{1, 2}));
+}
+
+void test_view_parse_random()
+{
+  using namespace std;
+  test_info("Checking csv_view_parser and chunk-fed csv_parser against csv_parser with random data ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  const auto header = string("# comment 1\n#comment, \"2\n\n");
+  for(int i = 0; i < 50; ++i) {
+    auto csv_text = header;
+    const auto num_rows = sw::utest::random<size_t>(1, 100);
+    const auto num_cols = sw::utest::random<size_t>(1, 8);
+    for(size_t row = 0; row < num_rows; ++row) {
+      csv_text += te::make_random_csv_row(composer, num_cols, 12, te::rnd_pool_ascii_with_newline() + "  \t");
+    }
+    for(const auto& trim_chars: {string_view(""), string_view(" \t")}) {
+      const auto expected = joined_rows_of_parser(csv_text, ',', "#", trim_chars);
+      for(const auto max_chunk_size: {size_t(1), size_t(7), size_t(64), csv_text.size()}) {
+        const auto parsed = joined_rows_of_view_parser(csv_text, ',', "#", trim_chars, max_chunk_size);
+        const auto parsed_chunked = joined_rows_of_chunked_parser(csv_text, ',', "#", trim_chars, max_chunk_size);
+        if(!test_expect_cond(parsed == expected) || !test_expect_cond(parsed_chunked == expected)) {
+          test_note("CSV text:\n" << csv_text);
+          test_note("Expected:\n" << expected);
+          test_note("Parsed:\n" << parsed);
+          test_note("Parsed by chunks (csv_parser):\n" << parsed_chunked);
+          return;
+        }
+      }
+    }
+  }
+}
+
+void test_view_parse_file()
+{
+  using namespace std;
+  test_info("Checking csv_view_parser::parse_file() (memory mapped) against csv_parser ...");
+  const auto path = te::make_random_csv_file(
+    "tcsv-view", 256, 6, ',', "# header comment", 24, te::rnd_pool_ascii_with_newline());
+  auto expected = string();
+  auto parsed = string();
+  test_expect_noexcept(csv::csv_parser(
+                         [&](const vector<string>& fields, size_t line_no) {
+                           expected += te::csv_escape_joined_row_fields(fields, line_no) + "\n";
+                         },
+                         ',', "#")
+                         .parse_file(path));
+  test_expect_noexcept(csv::csv_view_parser(
+                         [&](const vector<string_view>& fields, size_t line_no) {
+                           parsed += te::csv_escape_joined_row_fields(vector<string>(fields.begin(), fields.end()), line_no) + "\n";
+                         },
+                         ',', "#")
+                         .parse_file(path));
+  test_expect(!expected.empty());
+  test_expect(parsed == expected);
+#if !defined(WITHOUT_CSV_MMAP)
+  {
+    const auto mapped = csv::detail::mapped_file(path);
+    test_expect(mapped.is_open());
+    test_expect_eq(mapped.size(), size_t(filesystem::file_size(path)));
+  }
+#endif
+  filesystem::remove(path);
+
+  test_info("Checking csv_view_parser::parse_file() with empty and nonexistent files ...");
+  const auto empty_path = filesystem::path("tcsv-view-empty.csv");
+  { auto os = ofstream(empty_path, ios::binary); }
+  auto num_rows = size_t(0);
+  const auto count_rows = [&](const vector<string_view>&, size_t) { ++num_rows; };
+  test_expect(!csv::detail::mapped_file(empty_path).is_open());
+  test_expect_noexcept(csv::csv_view_parser(count_rows).parse_file(empty_path));
+  test_expect_eq(num_rows, size_t(0));
+  filesystem::remove(empty_path);
+  test_expect_except(csv::csv_view_parser(count_rows).parse_file("./no-such-file-or-directory.csv"));
+}
+
+void test_view_parse_file_parallel()
+{
+  using namespace std;
+  test_info("Checking csv_view_parser::parse_file_parallel() against parse_file() ...");
+  // Small (run-time) read buffer size -> small minimum range size, many range boundaries within fields.
+  using parser_type = csv::csv_view_parser;
+  constexpr auto read_buffer_size = size_t(4096);
+  const auto path = te::make_random_csv_file(
+    "tcsv-parallel", 512, 5, ',', "# header comment\r\n#\n", 300, te::rnd_pool_ascii_with_newline() + "\"\"\"");
+  auto expected = map<size_t, string>();
+  auto parsed = map<size_t, string>();
+  auto parsed_mutex = mutex();
+  auto num_duplicates = size_t(0);
+  test_expect_noexcept(parser_type(
+                         [&](const vector<string_view>& fields, size_t line_no) {
+                           expected[line_no] = te::csv_escape_joined_row_fields(vector<string>(fields.begin(), fields.end()), line_no);
+                         },
+                         ',', "#")
+                         .read_buffer_size(read_buffer_size)
+                         .parse_file(path));
+  for(const auto num_threads: {size_t(2), size_t(7), size_t(32)}) {
+    parsed.clear();
+    test_expect_noexcept(parser_type(
+                           [&](const vector<string_view>& fields, size_t line_no) {
+                             auto row = te::csv_escape_joined_row_fields(vector<string>(fields.begin(), fields.end()), line_no);
+                             const auto lock = lock_guard<mutex>(parsed_mutex);
+                             if(!parsed.emplace(line_no, std::move(row)).second) ++num_duplicates;
+                           },
+                           ',', "#")
+                           .read_buffer_size(read_buffer_size)
+                           .parse_file_parallel(path, num_threads));
+    test_expect_eq(num_duplicates, size_t(0));
+    test_expect_eq(parsed.size(), expected.size());
+    test_expect(parsed == expected);
+  }
+  test_info("Checking parse_file_parallel() row handler exception forwarding ...");
+  test_expect_except(parser_type([&](const vector<string_view>&, size_t) { throw std::runtime_error("row handler error"); })
+                       .read_buffer_size(read_buffer_size)
+                       .parse_file_parallel(path, 4));
+  test_info("Checking the run-time read buffer size of csv_view_parser file parsing ...");
+  using stats_parser_type = csv::detail::basic_parser<1024, string, vector<string_view>, std::function<void(const vector<string_view>&, size_t)>, csv::detail::dynamic_dialect, csv::csv_parser_stats>;
+  const auto file_size = size_t(filesystem::file_size(path));
+  auto parser = stats_parser_type([](const vector<string_view>&, size_t) {}, ',', "#");
+  test_expect_noexcept(parser.parse_file(path));
+  test_expect_eq(parser.stats().num_chunks, 1u);
+  test_expect_eq(parser.stats().max_chunk_size, file_size);
+  parser.read_buffer_size(read_buffer_size).stats().clear();
+  test_expect_noexcept(parser.parse_file(path));
+  test_expect_eq(parser.stats().num_chunks, (file_size + read_buffer_size - 1) / read_buffer_size);
+  test_expect_eq(parser.stats().max_chunk_size, read_buffer_size);
+  test_expect_eq(parser.stats().num_bytes, file_size);
+  parser.stats().clear();
+  test_expect_noexcept(parser.parse_file_pipelined(path));
+  test_expect_eq(parser.stats().max_chunk_size, read_buffer_size);
+  test_expect_eq(parser.stats().num_bytes, file_size);
+#if !defined(WITHOUT_CSV_MMAP)
+  parser.stats().clear();
+  test_expect_noexcept(parser.parse_file_parallel(path, 4)); // Ranges: Header comments + 4 (not sequential with 1MB ranges).
+  test_expect_eq(parser.stats().num_chunks, 5u);
+  test_expect_eq(parser.stats().num_bytes, file_size);
+#endif
+  filesystem::remove(path);
+}
+
+void test_view_parser_features()
+{
+  using namespace std;
+  test_info("Checking csv_view_parser column selection, header row, and row limits ...");
+  auto rows = vector<string>();
+  const auto row_proc = [&](const vector<string_view>& fields, size_t line_no){
+    auto s = to_string(line_no) + ":";
+    for(const auto& field: fields) s += string(field) + "|";
+    rows.push_back(s);
+  };
+  {
+    auto header = csv::csv_header();
+    const auto text = string("id,\"na\"\"me\",price\r\n1,\"a\"\"b\",10\r\n2, c ,20\n");
+    auto parser = csv::csv_view_parser(row_proc, ',', "", " ");
+    parser.header_row(&header).select_columns(vector<string>{"price", "id"});
+    for(const auto& c: text) parser.feed(string_view(&c, 1));
+    parser.finish();
+    test_expect(rows == (vector<string>{"2:1|10|", "3:2|20|"}));
+    test_expect_eq(header.size(), 2u);
+    test_expect(header.index_of("id") == 0u && header.index_of("price") == 1u);
+  }
+  const auto text = string("a,b\n12345,c\nd,e\n1,2,3,4\n\"ab\ncd\",x\n\"unterminated\nf,g\nhijklm,n\nabc,de,f\nabc,de,fg\n\"\"\"\"\"\"\"\"\"\"\"\"\n\"h\"\"\",i");
+  const auto expected = vector<string>{"1:a|b|", "3:d|e|", "7:f|g|", "9:abc|de|f|", "12:h\"|i|"};
+  auto parser = csv::csv_view_parser(row_proc);
+  parser.limits({4, 3, 6, csv::csv_limit_policy::error});
+  test_expect_except(parser.parse("a,b\n12345,c\n"));
+  parser.clear().limits({4, 3, 6, csv::csv_limit_policy::skip_row});
+  rows.clear();
+  test_expect_noexcept(parser.parse(text));
+  test_expect(rows == expected);
+  test_expect_eq(parser.num_skipped_rows(), 7u);
+  rows.clear();
+  parser.clear();
+  for(const auto& c: text) parser.feed(string_view(&c, 1));
+  parser.finish();
+  test_expect(rows == expected);
+  test_expect_eq(parser.num_skipped_rows(), 7u);
+
+  test_info("Checking csv_view_parser statistics and parse_file_parallel() with a header row selection ...");
+  using stats_view_parser = csv::detail::basic_parser<1, string, vector<string_view>, std::function<void(const vector<string_view>&, size_t)>, csv::detail::dynamic_dialect, csv::csv_parser_stats>;
+  const auto path = te::make_random_csv_file(
+    "tcsv-view-header", 256, 5, ',', "# header comment\nc1,c2,c3,c4,c5\n", 200, te::rnd_pool_ascii_with_newline() + "\"\"\"");
+  auto expected_stats = csv::csv_parser_stats();
+  auto expected_rows = map<size_t, string>();
+  {
+    auto parser = csv::csv_instrumented_parser([&](const vector<string>& fields, size_t line_no){
+      expected_rows[line_no] = te::csv_escape_joined_row_fields(fields, line_no);
+    }, ',', "#");
+    test_expect_noexcept(parser.select_columns(vector<string>{"c4", "c2"}).parse_file(path));
+    expected_stats = parser.stats();
+  }
+  test_expect(expected_rows.size() > 100);
+  for(const auto num_threads: {size_t(1), size_t(5)}) {
+    auto parsed_rows = map<size_t, string>();
+    auto parsed_mutex = mutex();
+    auto parser = stats_view_parser([&](const vector<string_view>& fields, size_t line_no){
+      auto row = te::csv_escape_joined_row_fields(vector<string>(fields.begin(), fields.end()), line_no);
+      const auto lock = lock_guard<mutex>(parsed_mutex);
+      parsed_rows[line_no] = std::move(row);
+    }, ',', "#");
+    test_expect_noexcept(parser.select_columns(vector<string>{"c4", "c2"}).parse_file_parallel(path, num_threads));
+    test_expect(parsed_rows == expected_rows);
+    test_expect_eq(parser.stats().num_rows, expected_stats.num_rows);
+    test_expect_eq(parser.stats().num_fields, expected_stats.num_fields);
+    test_expect_eq(parser.stats().num_quoted_fields, expected_stats.num_quoted_fields);
+    test_expect_eq(parser.stats().max_field_size, expected_stats.max_field_size);
+    test_expect_eq(parser.stats().num_bytes, expected_stats.num_bytes);
+  }
+  filesystem::remove(path);
+}
+
+void test_row_batcher()
+{
+  using namespace std;
+  test_info("Checking csv_row_batcher with random data ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  for(int i = 0; i < 20; ++i) {
+    auto csv_text = string();
+    const auto num_rows = sw::utest::random<size_t>(1, 100);
+    const auto num_cols = sw::utest::random<size_t>(1, 8);
+    for(size_t row = 0; row < num_rows; ++row) {
+      csv_text += te::make_random_csv_row(composer, num_cols, 12, te::rnd_pool_ascii_with_newline());
+    }
+    const auto expected = joined_rows_of_parser(csv_text, ',', "", "");
+    const auto max_rows = sw::utest::random<size_t>(1, 16);
+    const auto max_bytes = sw::utest::random<size_t>(1, 256);
+    auto parsed = string();
+    auto num_batches = size_t(0);
+    auto num_batched_rows = size_t(0);
+    auto batcher = csv::csv_row_batcher([&](const csv::csv_row_batch& batch) {
+      ++num_batches;
+      num_batched_rows += batch.size();
+      test_expect_cond(!batch.empty() && (batch.size() <= max_rows));
+      for(size_t row = 0; row < batch.size(); ++row) {
+        auto fields = vector<string>();
+        for(size_t col = 0; col < batch.num_fields(row); ++col) {
+          fields.emplace_back(batch.field(row, col));
+        }
+        parsed += te::csv_escape_joined_row_fields(fields, batch.line_no(row)) + "\n";
+      }
+    }, max_rows, max_bytes);
+    test_expect_noexcept(csv::csv_inline_view_parser<decltype(std::ref(batcher))>(std::ref(batcher)).parse(csv_text));
+    batcher.flush();
+    if(!test_expect_cond(parsed == expected)) {
+      test_note("CSV text:\n" << csv_text);
+      test_note("Expected:\n" << expected);
+      test_note("Parsed:\n" << parsed);
+      return;
+    }
+    test_expect_cond(num_batches >= (num_batched_rows + max_rows - 1) / max_rows);
+  }
+}
+
+void test_column_batcher()
+{
+  using namespace std;
+  test_info("Checking csv_column_batcher and csv_composer::feed_batch() with random data ...");
+  const auto composer = csv::csv_composer(csv::csv_composer::no_output, ',');
+  for(int i = 0; i < 20; ++i) {
+    auto csv_text = string();
+    const auto num_rows = sw::utest::random<size_t>(1, 100);
+    const auto num_cols = sw::utest::random<size_t>(1, 8);
+    for(size_t row = 0; row < num_rows; ++row) {
+      csv_text += te::make_random_csv_row(composer, num_cols, 12, te::rnd_pool_ascii_with_newline());
+    }
+    const auto expected = joined_rows_of_parser(csv_text, ',', "", "");
+    auto expected_csv = string();
+    {
+      auto out = csv::csv_composer([&](const string& line){ expected_csv += line; }, ',', "\n");
+      out.define_columns(num_cols);
+      csv::csv_view_parser([&](const vector<string_view>& fields, size_t){ if(fields.size() == num_cols) out.feed(fields); }).parse(csv_text);
+    }
+    const auto max_rows = sw::utest::random<size_t>(1, 16);
+    auto parsed = string();
+    auto composed = string();
+    auto out = csv::csv_composer([&](const string& line){ composed += line; }, ',', "\n");
+    out.define_columns(num_cols);
+    auto batcher = csv::csv_column_batcher([&](const csv::csv_column_batch& batch) {
+      test_expect_cond(!batch.empty() && (batch.size() <= max_rows));
+      auto data_size = size_t(0);
+      for(size_t col = 0; col < batch.num_columns(); ++col) {
+        test_expect_cond(batch.column_offsets(col).size() == batch.size() + 1);
+        test_expect_cond(batch.column_offsets(col).back() == batch.column_data(col).size());
+        data_size += batch.column_data(col).size();
+      }
+      test_expect_cond(data_size == batch.data_size());
+      for(size_t row = 0; row < batch.size(); ++row) {
+        auto fields = vector<string>();
+        for(size_t col = 0; col < batch.num_columns(); ++col) fields.emplace_back(batch.field(row, col));
+        parsed += te::csv_escape_joined_row_fields(fields, batch.line_no(row)) + "\n";
+      }
+      if(batch.num_columns() == num_cols) out.feed_batch(batch);
+    }, max_rows);
+    test_expect_noexcept(csv::csv_inline_view_parser<decltype(std::ref(batcher))>(std::ref(batcher)).parse(csv_text));
+    batcher.flush();
+    if(!test_expect_cond(parsed == expected)) {
+      test_note("CSV text:\n" << csv_text);
+      test_note("Expected:\n" << expected);
+      test_note("Parsed:\n" << parsed);
+      return;
+    }
+    test_expect_cond(composed == expected_csv);
+  }
+  {
+    // Rows with differing field counts: Columns are added, missing fields are empty.
+    auto batch = csv::csv_column_batch();
+    batch.push_back(vector<string>{"a"}, 1).push_back(vector<string>{"b", "cc", "d"}, 2).push_back(vector<string>{}, 3).push_back(vector<string>{"e", "f"}, 4);
+    test_expect_eq(batch.size(), size_t(4));
+    test_expect_eq(batch.num_columns(), size_t(3));
+    test_expect(batch.column_data(0) == "abe");
+    test_expect(batch.column_offsets(0) == (vector<size_t>{0, 1, 2, 2, 3}));
+    test_expect(batch.column_data(1) == "ccf");
+    test_expect(batch.column_offsets(1) == (vector<size_t>{0, 0, 2, 2, 3}));
+    test_expect(batch.column_offsets(2) == (vector<size_t>{0, 0, 1, 1, 1}));
+    test_expect(batch.field(1, 1) == "cc");
+    test_expect(batch.field(3, 2).empty());
+    test_expect_eq(batch.data_size(), size_t(7));
+    test_expect_eq(batch.line_no(3), size_t(4));
+    batch.clear();
+    test_expect(batch.empty() && (batch.num_columns() == 0) && (batch.data_size() == 0));
+    batch.push_back(vector<string>{"x", "y"}, 7);
+    test_expect(batch.column_data(0) == "x");
+    test_expect(batch.column_offsets(1) == (vector<size_t>{0, 1}));
+  }
+}
+
+void test_typed_parser()
+{
+  using namespace std;
+  test_info("Checking csv_typed_parser with fixed data ...");
+  {
+    const auto csv_text = string_view("1,2.5,abc\n-7,\"1e3\",\"x\"\"y\"\nx,,z\n99999999999999999999,1.5x\n3\n");
+    auto ints = vector<int64_t>();
+    auto doubles = vector<double>();
+    auto texts = vector<string>();
+    auto errors = vector<array<errc, 3>>();
+    auto line_numbers = vector<size_t>();
+    const auto on_row = [&](const tuple<int64_t, double, string_view>& row, const array<errc, 3>& cell_errors, size_t line_no) {
+      ints.push_back(get<0>(row));
+      doubles.push_back(get<1>(row));
+      texts.emplace_back(get<2>(row));
+      errors.push_back(cell_errors);
+      line_numbers.push_back(line_no);
+    };
+    test_expect_noexcept(csv::csv_typed_parser<int64_t, double, string_view>(on_row).parse(csv_text));
+    test_expect_eq(ints.size(), size_t(5));
+    if(ints.size() != 5) return;
+    test_expect(ints == (vector<int64_t>{1, -7, 0, 0, 3}));
+    test_expect(doubles == (vector<double>{2.5, 1e3, 0.0, 0.0, 0.0}));
+    test_expect(texts == (vector<string>{"abc", "x\"y", "z", "", ""}));
+    test_expect(line_numbers == (vector<size_t>{1, 2, 3, 4, 5}));
+    test_expect(errors[0] == (array<errc, 3>{errc(), errc(), errc()}));
+    test_expect(errors[1] == (array<errc, 3>{errc(), errc(), errc()}));
+    test_expect(errors[2] == (array<errc, 3>{errc::invalid_argument, errc::invalid_argument, errc()}));
+    test_expect(errors[3] == (array<errc, 3>{errc::result_out_of_range, errc::invalid_argument, errc::invalid_argument}));
+    test_expect(errors[4] == (array<errc, 3>{errc(), errc::invalid_argument, errc::invalid_argument}));
+  }
+  test_info("Checking csv_typed_parser with random numbers ...");
+  {
+    auto csv_text = string();
+    auto expected = vector<tuple<int32_t, uint64_t, double, string>>();
+    for(int i = 0; i < 1000; ++i) {
+      const auto row = make_tuple(
+        sw::utest::random<int32_t>(numeric_limits<int32_t>::min(), numeric_limits<int32_t>::max()),
+        sw::utest::random<uint64_t>(0, numeric_limits<uint64_t>::max()),
+        double(sw::utest::random<int32_t>(-1000000, 1000000)) / 64.0,
+        to_string(i)
+      );
+      expected.push_back(row);
+      csv_text += to_string(get<0>(row)) + "," + to_string(get<1>(row)) + "," + to_string(get<2>(row)) + "," + get<3>(row) + "\r\n";
+    }
+    auto parsed = vector<tuple<int32_t, uint64_t, double, string>>();
+    auto num_errors = size_t(0);
+    const auto on_row = [&](const auto& row, const auto& cell_errors, size_t) {
+      parsed.push_back(row);
+      for(const auto e: cell_errors) num_errors += (e != errc()) ? 1 : 0;
+    };
+    test_expect_noexcept(csv::csv_typed_parser<int32_t, uint64_t, double, string>(on_row).parse(csv_text));
+    test_expect_eq(num_errors, size_t(0));
+    test_expect(parsed == expected);
+  }
+}
+
+void test(const std::vector<std::string>&)
+{
+  test_view_parse_fixed();
+  test_view_parse_random();
+  test_view_parse_file();
+  test_view_parse_file_parallel();
+  test_view_parser_features();
+  test_row_batcher();
+  test_column_batcher();
+  test_typed_parser();
+}
@@ -0,0 +1,147 @@
+/**
+ * @test parse-compressed
+ *
+ * Checks `parse_compressed_file()` of csv::csv_parser and
+ * csv::csv_view_parser with plain, gzip and zstd files
+ * against `parse_file()`. Compressed files are only checked
+ * if the corresponding support is enabled (`make WITH_CSV_ZLIB=1`,
+ * `WITH_CSV_ZSTD=1`), otherwise the expected exception is checked.
+ */
+#include <testenv.hh>
+#include <include/csv.hh>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::string read_file(const std::filesystem::path& path)
+  {
+    auto fis = std::ifstream(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(fis), std::istreambuf_iterator<char>());
+  }
+
+  void write_file(const std::filesystem::path& path, const std::string& data)
+  {
+    auto fos = std::ofstream(path, std::ios::binary);
+    fos.write(data.data(), std::streamsize(data.size()));
+  }
+
+  std::string gzip_compressed(const std::string& data)
+  {
+    #if defined(WITH_CSV_ZLIB)
+    auto strm = z_stream();
+    if(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return std::string();
+    auto out = std::string(deflateBound(&strm, uLong(data.size())), '\0');
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    strm.avail_in = uInt(data.size());
+    strm.next_out = reinterpret_cast<Bytef*>(out.data());
+    strm.avail_out = uInt(out.size());
+    const auto ret = deflate(&strm, Z_FINISH);
+    out.resize(strm.total_out);
+    deflateEnd(&strm);
+    return (ret == Z_STREAM_END) ? out : std::string();
+    #else
+    (void)data;
+    return std::string("\x1f\x8b\x08\x00\x00\x00\x00\x00", 8); // Header only, sufficient for the detection.
+    #endif
+  }
+
+  std::string zstd_compressed(const std::string& data)
+  {
+    #if defined(WITH_CSV_ZSTD)
+    auto out = std::string(ZSTD_compressBound(data.size()), '\0');
+    const auto n = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 3);
+    if(ZSTD_isError(n)) return std::string();
+    out.resize(n);
+    return out;
+    #else
+    (void)data;
+    return std::string("\x28\xb5\x2f\xfd\x00\x00", 6); // Magic only, sufficient for the detection.
+    #endif
+  }
+
+  template<typename Parser, typename Handler>
+  std::string joined_rows(const std::filesystem::path& path, const Handler& handler, bool compressed, std::string& rows)
+  {
+    rows.clear();
+    auto parser = Parser(handler, ',', "#");
+    if(compressed) {
+      parser.parse_compressed_file(path);
+    } else {
+      parser.parse_file(path);
+    }
+    return rows;
+  }
+
+}
+
+void test_parse_compressed()
+{
+  using namespace std;
+  using parser_type = csv::detail::basic_parser<1, string, vector<string>>; // Small chunks (1kb, rounded up to 4kb)
+  using view_parser_type = csv::detail::basic_view_parser<1, string, vector<string_view>>;
+  const auto plain_path = te::make_random_csv_file("tcsv-compressed", 128, 5, ',', "#header\n", 40, te::rnd_pool_ascii_with_newline());
+  const auto gzip_path = std::filesystem::path("tcsv-compressed.csv.gz");
+  const auto zstd_path = std::filesystem::path("tcsv-compressed.csv.zst");
+  const auto truncated_path = std::filesystem::path("tcsv-compressed-truncated.csv.x");
+  const auto data = read_file(plain_path);
+  test_expect(!data.empty());
+
+  auto rows = string();
+  const auto on_row = [&](const vector<string>& fields, size_t line_no) {
+    rows += te::csv_escape_joined_row_fields(fields, line_no) + "\n";
+  };
+  const auto on_view_row = [&](const vector<string_view>& fields, size_t line_no) {
+    rows += te::csv_escape_joined_row_fields(vector<string>(fields.begin(), fields.end()), line_no) + "\n";
+  };
+  const auto expected = joined_rows<parser_type>(plain_path, on_row, false, rows);
+  const auto expected_view = joined_rows<view_parser_type>(plain_path, on_view_row, false, rows);
+  test_expect(!expected.empty());
+  test_expect(!expected_view.empty());
+
+  test_info("Checking parse_compressed_file() with a plain file ...");
+  test_expect(csv::detail::compression_of(plain_path) == csv::detail::file_compression::none);
+  test_expect(joined_rows<parser_type>(plain_path, on_row, true, rows) == expected);
+  test_expect(joined_rows<view_parser_type>(plain_path, on_view_row, true, rows) == expected_view);
+  test_expect_except(parser_type(on_row).parse_compressed_file("./no-such-file-or-directory.csv"));
+
+  const auto check_compressed = [&](const std::filesystem::path& path, const string& compressed, csv::detail::file_compression compression, bool enabled) {
+    test_expect(!compressed.empty());
+    write_file(path, compressed);
+    test_expect(csv::detail::compression_of(path) == compression);
+    if(!enabled) {
+      test_expect_except(parser_type(on_row).parse_compressed_file(path));
+      test_expect_except(view_parser_type(on_view_row).parse_compressed_file(path));
+    } else {
+      test_expect(joined_rows<parser_type>(path, on_row, true, rows) == expected);
+      test_expect(joined_rows<view_parser_type>(path, on_view_row, true, rows) == expected_view);
+      write_file(truncated_path, compressed.substr(0, compressed.size() / 2));
+      test_expect_except(parser_type(on_row).parse_compressed_file(truncated_path));
+      test_expect_except(view_parser_type(on_view_row).parse_compressed_file(truncated_path));
+      std::filesystem::remove(truncated_path);
+    }
+    std::filesystem::remove(path);
+  };
+
+  #if defined(WITH_CSV_ZLIB)
+  test_info("Checking parse_compressed_file() with a gzip file ...");
+  check_compressed(gzip_path, gzip_compressed(data), csv::detail::file_compression::gzip, true);
+  #else
+  test_info("Checking parse_compressed_file() with a gzip file (zlib support disabled) ...");
+  check_compressed(gzip_path, gzip_compressed(data), csv::detail::file_compression::gzip, false);
+  #endif
+  #if defined(WITH_CSV_ZSTD)
+  test_info("Checking parse_compressed_file() with a zstd file ...");
+  check_compressed(zstd_path, zstd_compressed(data), csv::detail::file_compression::zstd, true);
+  #else
+  test_info("Checking parse_compressed_file() with a zstd file (zstd support disabled) ...");
+  check_compressed(zstd_path, zstd_compressed(data), csv::detail::file_compression::zstd, false);
+  #endif
+  std::filesystem::remove(plain_path);
+}
+
+void test(const std::vector<std::string>&)
+{
+  test_parse_compressed();
+}